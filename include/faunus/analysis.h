@@ -8,7 +8,11 @@
 #include <faunus/group.h>
 #include <faunus/space.h>
 #include <faunus/point.h>
+#include <faunus/geometry.h>
 #include <faunus/textio.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #endif
 
 namespace Faunus {
@@ -39,6 +43,8 @@ namespace Faunus {
       private:
         virtual string _info()=0; //!< info all classes must provide
         virtual void _test(UnitTest&);
+        virtual void _save(std::ostream&);   //!< Write accumulators of derived class
+        virtual bool _load(std::istream&);   //!< Read accumulators of derived class
       protected:
         char w;               //!< width of info
         unsigned long int cnt;//!< number of samples - increased for every run()==true.
@@ -51,6 +57,8 @@ namespace Faunus {
         string info();       //!< Print info and results
         double runfraction;  //!< Chance that analysis should be run (default 1.0 = 100%)
         void test(UnitTest&);//!< Perform unit test
+        void save(std::ostream&); //!< Write state to binary stream (see `Checkpoint`)
+        bool load(std::istream&); //!< Restore state from binary stream
     };
 
     /**
@@ -190,6 +198,189 @@ namespace Faunus {
           }
       };
 
+    /**
+     * @brief Table of equidistant xy data stored in a contiguous array
+     *
+     * This has the same interface and file format as `Table2D` but bins are
+     * kept in a `std::vector` so that access is a direct index lookup instead
+     * of a search in a `std::map` with floating point keys. The range grows
+     * automatically to include any accessed `x` but can be pre-allocated with
+     * `setRange()`. As for `Table2D`, `x` is rounded to the nearest multiple
+     * of the resolution. Only non-empty bins are saved to disk, meaning that
+     * for histograms the output is identical to that of `Table2D`.
+     *
+     * @date Lund 2014
+     */
+    template<typename Tx, typename Ty>
+      class Table2DArray {
+        protected:
+          Tx dx;
+          int i0;                 //!< Bin number of first element
+          std::vector<Ty> vec;    //!< y values of bins i0, i0+1, ...
+          string name;
+
+          Ty count() {
+            Ty cnt=0;
+            for (auto &y : vec)
+              cnt+=y;
+            return cnt;
+          }
+
+          /** @brief Number of non-empty bins */
+          size_t size() const {
+            size_t n=0;
+            for (auto &y : vec)
+              if (y!=Ty())
+                n++;
+            return n;
+          }
+
+          /** @brief Bin number of `x` */
+          inline int bin(Tx x) const { return (x>=0) ? int( x/dx+0.5 ) : int( x/dx-0.5 ); }
+
+          /** @brief x value of i'th array element */
+          inline Tx xval(int i) const { return Tx(i+i0)*dx; }
+
+        private:
+          virtual double get(Tx x) { return operator()(x); }
+
+          void expand(int k) {
+            if (vec.empty()) {
+              i0=k;
+              vec.resize(1);
+            } else if (k<i0) {
+              vec.insert(vec.begin(), i0-k, Ty());
+              i0=k;
+            } else if (k-i0>=int(vec.size()))
+              vec.resize(k-i0+1);
+          }
+
+        public:
+          enum type {HISTOGRAM, XYDATA};
+          type tabletype;
+
+          /**
+           * @brief Constructor
+           * @param resolution Resolution of the x axis
+           * @param key Table type: HISTOGRAM or XYDATA
+           */
+          Table2DArray(Tx resolution=0.2, type key=XYDATA) : i0(0) {
+            tabletype=key;
+            setResolution(resolution);
+          }
+
+          virtual ~Table2DArray() {}
+
+          void clear() { vec.clear(); }
+
+          void setResolution(Tx resolution) {
+            assert( resolution>0 );
+            dx=resolution;
+            vec.clear();
+          }
+
+          /** @brief Pre-allocate bins in the interval `[min:max]` */
+          void setRange(Tx min, Tx max) {
+            assert(min<=max);
+            expand(bin(min));
+            expand(bin(max));
+          }
+
+          /** @brief Access operator - returns reference to y(x) */
+          Ty& operator() (Tx x) {
+            int k=bin(x);
+            if (vec.empty() || k<i0 || k-i0>=int(vec.size()))
+              expand(k);
+            return vec[k-i0];
+          }
+
+          /** @brief Add `y` to bin number `k`, i.e. to `x=k*dx` */
+          void addBin(int k, Ty y) {
+            expand(k);
+            vec[k-i0]+=y;
+          }
+
+          /** @brief Save table to disk */
+          void save(string filename) {
+            int first=-1, last=-1;
+            for (int i=0; i<int(vec.size()); i++)
+              if (vec[i]!=Ty()) {
+                if (first<0) first=i;
+                last=i;
+              }
+            if (first<0)
+              return;
+            if (tabletype==HISTOGRAM) {
+              vec[first]*=2;                  // compensate for half bin width
+              if (last!=first) vec[last]*=2;  // -//-
+            }
+            std::ofstream f(filename.c_str());
+            f.precision(10);
+            if (f) {
+              f << "# Faunus 2D table: " << name << endl;
+              for (int i=first; i<=last; i++)
+                if (vec[i]!=Ty())
+                  f << xval(i) << " " << get( xval(i) ) << endl;
+            }
+            if (tabletype==HISTOGRAM) {
+              vec[first]/=2;                  // restore half bin width
+              if (last!=first) vec[last]/=2;  // -//-
+            }
+          }
+
+          /*! Returns x at minumum y */
+          Tx miny() {
+            assert(!vec.empty());
+            Ty min=std::numeric_limits<Ty>::max();
+            Tx x=0;
+            for (int i=0; i<int(vec.size()); i++)
+              if (vec[i]!=Ty() && vec[i]<min) {
+                min=vec[i];
+                x=xval(i);
+              }
+            return x;
+          }
+
+          /*! Returns x at maximum y */
+          Tx maxy() {
+            assert(!vec.empty());
+            Ty max=std::numeric_limits<Ty>::min();
+            Tx x=0;
+            for (int i=0; i<int(vec.size()); i++)
+              if (vec[i]!=Ty() && vec[i]>max) {
+                max=vec[i];
+                x=xval(i);
+              }
+            return x;
+          }
+
+          /*! Returns x at minumum x */
+          Tx minx() {
+            for (int i=0; i<int(vec.size()); i++)
+              if (vec[i]!=Ty())
+                return xval(i);
+            return 0;
+          }
+
+          /**
+           * @brief Load table from disk
+           * @note The first line - used for comments - is ignored.
+           */
+          bool load(const string &filename) {
+            std::ifstream f(filename.c_str());
+            if (f) {
+              vec.clear();
+              f.ignore(std::numeric_limits<std::streamsize>::max(),'\n'); // ignore first line
+              Tx x;
+              double y;
+              while (f >> x >> y)
+                operator()(x)=y;
+              return true;
+            }
+            return false;
+          }
+      };
+
     /*!
       \brief General class for penalty functions along a coordinate
       \date Malmo, 2011
@@ -299,12 +490,19 @@ namespace Faunus {
      * This radial distribution is defined as \f$ g(r) = \rho(r) / \rho(\infty) \f$ where \f$ \rho \f$ are
      * the particle densities in spherical volume element `rdr` and in the bulk, respectively.
      *
+     * Bins are stored in a `Table2DArray`. When sampling, only particles of the two
+     * requested types are considered and if `maxdist` is finite and the geometry
+     * is a `Geometry::Cuboid`, pairs are found using a cell list so that the cost is
+     * proportional to the number of particles rather than to the number of pairs.
+     * With OpenMP, sampling runs in parallel using a histogram for each thread.
+     *
      * Example:
      *
      * ~~~
      * short cation = atom["Na"].id;
      * short anion = atom["Cl"].id;
      * Analysis::RadialDistribution<float,unsigned int> rdf(0.2); // 0.2 Å resolution
+     * rdf.maxdist = 20;                                          // optional
      * rdf.sample( myspace, mygroup, cation, anion );
      * rdf.save("rdf.dat");
      * ~~~
@@ -312,9 +510,9 @@ namespace Faunus {
      * \date Lund 2011
      */
     template<typename Tx=float, typename Ty=unsigned long long int>
-      class RadialDistribution : public Table2D<Tx,Ty> {
+      class RadialDistribution : public Table2DArray<Tx,Ty> {
         private:
-          typedef Table2D<Tx,Ty> Ttable;
+          typedef Table2DArray<Tx,Ty> Ttable;
           virtual double volume(Tx x) {
             return 4./3.*pc::pi*( pow(x+0.5*this->dx,3) - pow(x-0.5*this->dx,3) );
           }
@@ -323,9 +521,11 @@ namespace Faunus {
             assert( this->count()>0 );
             if (bulkconc.cnt==0) bulkconc+=1;
             return (double)this->operator()(x) / volume(x) / (double)this->count() / bulkconc.avg()
-              * this->map.size() * this->dx;
+              * this->size() * this->dx;
           }
           Average<double> bulkconc; //!< Average bulk concentration
+          p_vec sel;                //!< Positions of selected particles
+          Geometry::CellList<Geometry::Cuboid> cells;
         public:
           Tx maxdist; //!< Pairs with distances above this value will be skipped (default: infinity)
 
@@ -346,18 +546,57 @@ namespace Faunus {
            * \param idb Atom id of second particle
            */
           void sample(Space &spc, Group &g, short ida, short idb) {
-            for (auto i=g.begin(); i!=g.end()-1; i++)
-              for (auto j=i+1; j!=g.end(); j++)
-                if ( (spc.p[*i].id==ida && spc.p[*j].id==idb) || (spc.p[*i].id==idb && spc.p[*j].id==ida) ) {
-                  Tx r=spc.geo->dist(spc.p[*i], spc.p[*j]);
-                  if (r<=maxdist)
-                    this->operator() (r)++; 
-                }
-            double bulk=0;
+            sel.clear();
             for (auto i : g)
               if (spc.p[i].id==ida || spc.p[i].id==idb)
-                bulk++;
-            bulkconc += bulk / spc.geo->getVolume();
+                sel.push_back( spc.p[i] );
+            int n=sel.size();
+            auto geo = dynamic_cast<Geometry::Cuboid*>(spc.geo);
+            bool usecells = (geo!=nullptr && maxdist<0.5*geo->len.minCoeff());
+            if (usecells) {
+              cells.setCutoff(maxdist);
+              cells.update(*geo, sel);
+            }
+            auto match = [&](int i, int j) {
+              return (sel[i].id==ida && sel[j].id==idb) || (sel[i].id==idb && sel[j].id==ida);
+            };
+
+            vector<vector<Ty> > hist(1);
+#pragma omp parallel if (n>1000)
+            {
+              int t=0;
+#ifdef _OPENMP
+#pragma omp single
+              hist.resize( omp_get_num_threads() );
+              t=omp_get_thread_num();
+#endif
+              vector<Ty> &h = hist[t];
+              auto add = [&](int i, int j) {
+                Tx r=spc.geo->dist(sel[i], sel[j]);
+                if (r<=maxdist) {
+                  size_t k=this->bin(r);
+                  if (k>=h.size())
+                    h.resize(k+1);
+                  h[k]++;
+                }
+              };
+#pragma omp for schedule(dynamic,16)
+              for (int i=0; i<n; i++)
+                if (usecells) {
+                  for (auto c : cells.neighbours( cells.index(sel[i]) ))
+                    for (auto j : cells[c])
+                      if (j>i && match(i,j))
+                        add(i,j);
+                } else
+                  for (int j=i+1; j<n; j++)
+                    if (match(i,j))
+                      add(i,j);
+            }
+            for (auto &h : hist)
+              for (size_t k=0; k<h.size(); k++)
+                if (h[k]>0)
+                  this->addBin(k, h[k]);
+            bulkconc += n / spc.geo->getVolume();
           }
       };
 
@@ -437,6 +676,7 @@ namespace Faunus {
     public:
       TwobodyForce(InputMap&, Energy::Energybase&, Space&, Group &, Group &, Group &);//!< Constructor
       virtual void calc();
+      using AnalysisBase::save;
       void save(string);
       void setTwobodies(Group &, Group &, Group &);
       virtual Point meanforce();
@@ -508,6 +748,8 @@ namespace Faunus {
         double gyrationRadiusSquared(const Group&, const Space &);
         Point vectorEnd2end(const Group&, const Space &);
         void _test(UnitTest&);
+        void _save(std::ostream&);
+        bool _load(std::istream&);
         string _info();
       public:
         PolymerShape();
@@ -535,6 +777,8 @@ namespace Faunus {
         double charge(const Group&, const Space&);
         double dipole(const Group&, const Space&);
         virtual bool exclude(const particle&);  //!< Determines particle should be excluded from analysis
+        void _save(std::ostream&);
+        bool _load(std::istream&);
         string _info();
       public:
         ChargeMultipole();
@@ -571,11 +815,13 @@ namespace Faunus {
      */
     class Widom : public AnalysisBase {
       private:
-        Space* spcPtr;
         Energy::Energybase* potPtr;
-        Average<double> expsum; //!< Average of the excess chemical potential 
         string _info();         //!< Print results of analysis
+        void _save(std::ostream&);
+        bool _load(std::istream&);
       protected:
+        Space* spcPtr;
+        Average<double> expsum; //!< Average of the excess chemical potential 
         p_vec g;                //!< List of ghost particles to insert (simultaneously)
       public:
         Widom(Space&, Energy::Energybase&);
@@ -587,6 +833,121 @@ namespace Faunus {
         double muex();                           //!< Sampled mean excess chemical potential
     };
 
+    /**
+     * @brief Parallel Widom insertion using the pair potential directly
+     *
+     * This performs the same analysis as `Widom` but for a plain pair potential
+     * in a `Geometry::Cuboid`, given by a `Energy::Nonbonded` instance (or similar
+     * class with public `pairpot` and `geometry` members). Compared to
+     * `Widom::sample()`,
+     *
+     * - pair energies are evaluated directly, avoiding virtual calls,
+     * - insertions are distributed over OpenMP threads, each accumulating its
+     *   own average that is merged afterwards,
+     * - each insertion draws positions from its own counter-based random stream,
+     *   `RandomXoshiro::stream()`, so that the results do not depend on the number
+     *   of threads. The streams are seeded from `slp_global` in each call to
+     *   `sample()` and thus follow the seed of the simulation,
+     * - with `hardcore=true`, ghosts overlapping with a particle,
+     *   \f$ r<\sigma_i+\sigma_j \f$, are rejected after checking only the
+     *   surrounding cells of a `Geometry::CellList`.
+     *   This is off by default as it is valid only if the pair potential is
+     *   infinite for overlapping particles.
+     *
+     * The pair potential must be safe to call from several threads.
+     *
+     * ~~~~
+     * Energy::Nonbonded<Potential::CoulombHS,Geometry::Cuboid> nb(mcp);
+     * Analysis::WidomParallel<decltype(nb)> widom(spc, nb);
+     * widom.addGhost(spc);
+     * widom.sample(1e5);
+     * ~~~~
+     *
+     * @date Lund 2014
+     */
+    template<class Tnonbonded>
+      class WidomParallel : public Widom {
+        private:
+          Tnonbonded* nb;
+          RandomXoshiro rng; //!< Source of per-insertion streams, seeded from `slp_global`
+          Geometry::CellList<Geometry::Cuboid> cells;
+        public:
+          bool hardcore;     //!< Reject overlapping ghosts early (default: false)
+
+          WidomParallel(Space &spc, Tnonbonded &nonbonded) : Widom(spc, nonbonded),
+          nb(&nonbonded), hardcore(false) {
+            static_assert( std::is_base_of<Geometry::Cuboid,decltype(nb->geometry)>::value,
+                "WidomParallel requires a Cuboid geometry" );
+            name="Multi Particle Widom Analysis (parallel)";
+          }
+
+          /** @brief Insert and analyse `ninsert` times */
+          void sample(int ninsert=10) {
+            if (!run())
+              return;
+            auto &geo = nb->geometry;
+            const p_vec &p = spcPtr->p;
+            int n=g.size(), N=p.size();
+
+            double rmax=0;
+            for (auto &i : p)
+              rmax=std::max(rmax, i.radius);
+            for (auto &i : g)
+              rmax=std::max(rmax, i.radius);
+            bool usecells = hardcore && rmax>0 && 2*rmax<0.5*geo.len.minCoeff();
+            if (usecells) {
+              cells.setCutoff(2*rmax);
+              cells.update(geo, p);
+            }
+
+            rng.seed( int(slp_global.rand()) );
+            Average<double> sum;
+#pragma omp parallel
+            {
+              Average<double> local;
+              p_vec ghost(g);
+#pragma omp for schedule(static)
+              for (int k=0; k<ninsert; k++) {
+                auto eng = rng.stream(k);
+                for (auto &a : ghost) {
+                  a.x() = (eng.uniform()-0.5) * geo.len.x();
+                  a.y() = (eng.uniform()-0.5) * geo.len.y();
+                  a.z() = (eng.uniform()-0.5) * geo.len.z();
+                }
+                bool overlap=false;
+                if (usecells)
+                  for (int i=0; i<n && !overlap; i++)
+                    for (auto c : cells.neighbours( cells.index(ghost[i]) )) {
+                      for (auto j : cells[c]) {
+                        double s=ghost[i].radius+p[j].radius;
+                        if (geo.sqdist(ghost[i],p[j]) < s*s) {
+                          overlap=true;
+                          break;
+                        }
+                      }
+                      if (overlap)
+                        break;
+                    }
+                if (overlap) {
+                  local += 0;
+                  continue;
+                }
+                double du=0;
+                for (int i=0; i<n; i++)
+                  for (int j=0; j<N; j++)
+                    du+=nb->pairpot( ghost[i], p[j], geo.sqdist(ghost[i],p[j]) );
+                for (int i=0; i<n-1; i++)
+                  for (int j=i+1; j<n; j++)
+                    du+=nb->pairpot( ghost[i], ghost[j], geo.sqdist(ghost[i],ghost[j]) );
+                local += exp(-du);
+              }
+#pragma omp critical
+              sum = sum + local;
+            }
+            expsum = expsum + sum;
+          }
+      };
+
     /**
      * @brief Single particle hard sphere Widom insertion with charge scaling
      *
@@ -0,0 +1,168 @@
+#ifndef FAU_CHECKPOINT_H
+#define FAU_CHECKPOINT_H
+
+#ifndef SWIG
+#include <faunus/common.h>
+#include <faunus/average.h>
+#include <functional>
+#include <cstdint>
+#endif
+
+namespace Faunus {
+
+  /**
+   * @brief Raw binary read and write of plain data
+   *
+   * Data is written in host byte order with no padding or conversion. Only
+   * types without virtual functions may be written directly. Vectors and
+   * maps are prefixed by their size.
+   */
+  namespace Binary {
+
+    template<class T>
+      void write(std::ostream &o, const T &x) {
+        static_assert(!std::is_polymorphic<T>::value, "cannot write polymorphic type");
+        o.write( (const char*)&x, sizeof(T) );
+      }
+
+    template<class T>
+      void read(std::istream &in, T &x) {
+        static_assert(!std::is_polymorphic<T>::value, "cannot read polymorphic type");
+        in.read( (char*)&x, sizeof(T) );
+      }
+
+    inline void write(std::ostream &o, const string &s) {
+      write(o, uint64_t(s.size()));
+      o.write( s.data(), s.size() );
+    }
+
+    inline void read(std::istream &in, string &s) {
+      uint64_t n=0;
+      read(in,n);
+      s.resize(n);
+      if (n>0)
+        in.read( &s[0], n );
+    }
+
+    template<class T, class Talloc>
+      void write(std::ostream &o, const std::vector<T,Talloc> &v) {
+        static_assert(!std::is_polymorphic<T>::value, "cannot write polymorphic type");
+        write(o, uint64_t(v.size()));
+        if (!v.empty())
+          o.write( (const char*)v.data(), v.size()*sizeof(T) );
+      }
+
+    template<class T, class Talloc>
+      void read(std::istream &in, std::vector<T,Talloc> &v) {
+        static_assert(!std::is_polymorphic<T>::value, "cannot read polymorphic type");
+        uint64_t n=0;
+        read(in,n);
+        v.resize(n);
+        if (n>0)
+          in.read( (char*)v.data(), n*sizeof(T) );
+      }
+
+    template<class T>
+      void write(std::ostream &o, const Average<T> &a) {
+        write(o,a.sum);
+        write(o,a.sqsum);
+        write(o,a.cnt);
+      }
+
+    template<class T>
+      void read(std::istream &in, Average<T> &a) {
+        read(in,a.sum);
+        read(in,a.sqsum);
+        read(in,a.cnt);
+      }
+
+    template<class Tkey, class Tval>
+      void write(std::ostream &o, const std::map<Tkey,Tval> &m) {
+        write(o, uint64_t(m.size()));
+        for (auto &i : m) {
+          write(o,i.first);
+          write(o,i.second);
+        }
+      }
+
+    template<class Tkey, class Tval>
+      void read(std::istream &in, std::map<Tkey,Tval> &m) {
+        uint64_t n=0;
+        read(in,n);
+        m.clear();
+        for (uint64_t i=0; i<n && in; i++) {
+          Tkey key;
+          read(in,key);
+          read(in,m[key]);
+        }
+      }
+
+  }//namespace
+
+  /**
+   * @brief Binary checkpoint of the simulation state
+   *
+   * Objects are registered with a unique key and are written as separate
+   * sections of a single binary file. An object `T` registered via `add()`
+   * must provide the functions `void save(std::ostream&)` and
+   * `bool load(std::istream&)` which is the case for `Space`,
+   * `RandomBase`, `Move::Movebase`, `Analysis::AnalysisBase` and `MCLoop`.
+   * Arbitrary data can be registered by giving the save and load functions
+   * directly.
+   *
+   * The file is first written to a temporary file which is then renamed so
+   * that a valid checkpoint is always present on disk, even if the program
+   * is killed while writing. Upon loading, all registered sections must be
+   * present and load without error, or else no object is changed. Sections
+   * in the file with no matching key are ignored.
+   *
+   * Data is stored as raw arrays in host byte order and the file is meant
+   * for restarting on the same architecture and with the same particle type.
+   * Both are checked when loading. Example:
+   *
+   * ~~~~
+   * Checkpoint cp("state.bin");
+   * cp.add("space", spc);
+   * cp.add("rng", slp_global);
+   * cp.add("translate", mv);
+   * cp.load();
+   * ...
+   * cp.save();
+   * ~~~~
+   *
+   * @date Lund, 2014
+   */
+  class Checkpoint {
+    public:
+      typedef std::function<void(std::ostream&)> Tsave;
+      typedef std::function<bool(std::istream&)> Tload;
+    private:
+      struct entry {
+        string key;
+        Tsave save;
+        Tload load;
+      };
+      std::vector<entry> reg;
+      unsigned int cntsave;
+    public:
+      static const uint32_t version=2; //!< File format version
+      string file;                     //!< Checkpoint file name
+
+      Checkpoint(string="checkpoint.bin");
+      void add(string, Tsave, Tload);  //!< Register section with save and load functions
+
+      /** @brief Register object with `save(std::ostream&)` and `load(std::istream&)` functions */
+      template<class T>
+        void add(string key, T &obj) {
+          add(key,
+              [&obj](std::ostream &o) { obj.save(o); },
+              [&obj](std::istream &in) { return obj.load(in); } );
+        }
+
+      bool save();                     //!< Write all registered sections to disk
+      bool load();                     //!< Read registered sections from disk
+      string info();
+  };
+
+}//namespace
+#endif
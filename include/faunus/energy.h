@@ -28,6 +28,14 @@ namespace Faunus {
    */
   namespace Energy {
 
+    /**
+     * @brief Number of OpenMP threads to use for a loop over `n` pair interactions
+     *
+     * Thread start-up is only paid off for sufficiently long loops so that each thread
+     * is given at least `minpairs` interactions. Returns 1 if compiled without OpenMP.
+     */
+    int ompThreads(int n, int minpairs=2000);
+
 
     /**
      *  @brief Base class for energy evaluation
@@ -39,6 +47,12 @@ namespace Faunus {
      *  implement `i_internal()`, for example.
      *
      *  @note All energy functions are expected to return energies in units of kT.
+     *  @note Classes that override `i2all()` must also override `i2all_change()`, if only
+     *        to forward to `Energybase::i2all_change()`, since the default implementation
+     *        in `Nonbonded` does not know about any additional terms.
+     *  @note Energies of trial configurations may be returned as `pc::infty` as soon as an
+     *        infinite contribution is found, without evaluating remaining terms
+     *        (early rejection). The old configuration is assumed to have finite energy.
      *  @todo Add setVolume() function such that each derived class may have it's own
      *        Geometry instance (if needed). This will significantly simplify the
      *        Hamiltonian class and increase performance by avoiding calling
@@ -69,21 +83,56 @@ namespace Faunus {
         virtual double i_internal(const p_vec&, int);         // External energy of i'th particle
         virtual double p_external(const particle&);           // External energy of particle
         double i_total(const p_vec&, int);                    // Total energy of i'th particle = i2all + i_external + i_internal
+        virtual double i2all_change(const p_vec&, const p_vec&, int); //!< i2all() in new minus old particle vector
+        double i_total_change(const p_vec&, const p_vec&, int); //!< i_total() in new minus old particle vector
         virtual double g2g(const p_vec&, Group&, Group&);     // Group-Group energy
         virtual double g2all(const p_vec&, Group&);           // Energy of Group with all other particles
         virtual double g_external(const p_vec&, Group&);      // External energy of group
         virtual double g_internal(const p_vec&, Group&);      // Internal energy of group
         virtual double v2v(const p_vec&, const p_vec&);       // Particle vector-Particle vector energy
         virtual double external();                            // External energy - pressure, for example.
+        virtual bool all2all_powers(const p_vec&, std::map<int,double>&); //!< Inverse power components of all2all()
         virtual string info();                                //!< Information
 
         virtual void field(const p_vec&, std::vector<Point>&);//!< Calculate electric field on all particles
 
-        virtual void trialUpdate(const Space&, std::set<int>&) {};
-        virtual void acceptUpdate() {};
-        virtual void rejectUpdate() {};
+        /**
+         * @brief Notification of a trial move
+         *
+         * Called by `Move::Movebase` after each trial move with a description
+         * of what was changed in `Space::trial`, see `Change`. If `Change::all()`
+         * is true, anything may have changed. Stateful energy classes (neighbour
+         * lists etc.) can use this together with `acceptUpdate()` and
+         * `rejectUpdate()`, which receive the same `Change`, to update
+         * incrementally.
+         */
+        virtual void trialUpdate(const Space&, const Change&) {};
+        virtual void acceptUpdate(const Change&) {}; //!< Trial move was accepted (`Space::p` now updated)
+        virtual void rejectUpdate(const Change&) {}; //!< Trial move was rejected (`Space::trial` now restored)
     };
 
+    /**
+     * @brief Add the electric field from all other particles to `E`
+     *
+     * Used by the `field()` functions of the nonbonded energy classes.
+     *
+     * @param pairpot Pair potential with a `field(particle, Point)` function
+     * @param geometry Geometry used for the distance vectors
+     * @param p Particle vector
+     * @param E Holds field on each particle. Must be of size N.
+     */
+    template<class Tpairpot, class Tgeometry>
+      void pairField(Tpairpot &pairpot, Tgeometry &geometry, const p_vec &p, std::vector<Point> &E) {
+        assert(p.size()==E.size());
+        size_t i=0;
+        for (auto &pi : p) {
+          for (auto &pj : p)
+            if (&pi!=&pj)
+              E[i]+=pairpot.field(pj, geometry.vdist(pi,pj));
+          i++;
+        }
+      }
+
     /**
      * @brief Energy class for non-bonded interactions.
      *
@@ -93,9 +142,41 @@ namespace Faunus {
      * - `double Tpairpot::operator()(const particle&, const particle&, double sqdist))`
      *
      * For a list of implemented potentials, see the Faunus::Potential namespace.
+     *
+     * Particle-group and group-group energies return `pc::infty` as soon as
+     * an infinite pair energy is found (early rejection). Single particle
+     * loops test each pair while double loops test after each particle in the
+     * outer loop. OpenMP threads skip remaining work once any thread has found
+     * an infinite energy.
      */
     template<class Tpairpot, class Tgeometry>
       class Nonbonded : public Energybase {
+        private:
+          bool _powers(const p_vec&, std::map<int,double>&, std::false_type) { return false; }
+
+          /** @brief Energy of subgroup `s` with the rest of the enclosing group `g` */
+          double outside(const p_vec &p, Group &s, Group &g) {
+            double u=0;
+            for (int i=g.front(); i<=g.back(); i++)
+              if (!s.find(i)) {
+                for (auto j : s)
+                  u+=pairpot(p[i],p[j],geometry.sqdist(p[i],p[j]));
+                if (u>=pc::infty)
+                  return pc::infty;
+              }
+            return u;
+          }
+
+          bool _powers(const p_vec &p, std::map<int,double> &m, std::true_type) {
+            int n=p.size();
+            std::vector<double> u(Tpairpot::npowers(), 0);
+            for (int i=0; i<n-1; ++i)
+              for (int j=i+1; j<n; ++j)
+                pairpot.powers( p[i],p[j],geometry.sqdist(p[i],p[j]),u.data() );
+            for (size_t k=0; k<u.size(); k++)
+              m[Tpairpot::power(k)] += u[k];
+            return true;
+          }
         protected:
           string _info() {
             return pairpot.info(25);
@@ -142,6 +223,11 @@ namespace Faunus {
             return u;
           }
 
+          /** @brief `all2all()` split into inverse powers - requires `Potential::has_powers` */
+          bool all2all_powers(const p_vec &p, std::map<int,double> &m) FOVERRIDE {
+            return _powers(p, m, std::integral_constant<bool,Potential::has_powers<Tpairpot>::value>());
+          }
+
           double i2i(const p_vec &p, int i, int j) FOVERRIDE {
             return pairpot( p[i], p[j], geometry.sqdist( p[i], p[j]) );
           }
@@ -150,14 +236,12 @@ namespace Faunus {
             double u=0;
             if ( !g.empty() ) {
               int len=g.back()+1;
-              if ( g.find(j) ) {   //j is inside g - avoid self interaction
-                for (int i=g.front(); i<j; i++)
-                  u+=pairpot(p[i],p[j],geometry.sqdist(p[i],p[j]));
-                for (int i=j+1; i<len; i++)
-                  u+=pairpot(p[i],p[j],geometry.sqdist(p[i],p[j]));
-              } else              //simple - j not in g
-                for (int i=g.front(); i<len; i++)
+              for (int i=g.front(); i<len; i++)
+                if (i!=j) {        // avoid self interaction if j is inside g
                   u+=pairpot( p[i], p[j], geometry.sqdist(p[i],p[j]));
+                  if (u>=pc::infty)
+                    return pc::infty;
+                }
             }
             return u;  
           }
@@ -166,13 +250,44 @@ namespace Faunus {
             assert(i>=0 && i<int(p.size()) && "index i outside particle vector");
             double u=0;
             int n=(int)p.size();
-            for (int j=0; j<i; ++j)
-              u+=pairpot( p[i], p[j], geometry.sqdist(p[i],p[j]) );
-            for (int j=i+1; j<n; ++j)
-              u+=pairpot( p[i], p[j], geometry.sqdist(p[i],p[j]) );
+            for (int j=0; j<n; ++j)
+              if (j!=i) {
+                u+=pairpot( p[i], p[j], geometry.sqdist(p[i],p[j]) );
+                if (u>=pc::infty)
+                  return pc::infty;
+              }
             return u;
           }
 
+          /**
+           * Old and new energies are evaluated in a single loop which,
+           * for large systems, is split over OpenMP threads (see `ompThreads()`).
+           */
+          double i2all_change(const p_vec &pnew, const p_vec &pold, int i) FOVERRIDE {
+            assert(pnew.size()==pold.size() && "particle vectors must have equal size");
+            const particle &a=pnew[i], &b=pold[i];
+            int n=(int)pnew.size(), stop=0;
+            double u=0;
+#ifdef _OPENMP
+            int nt=ompThreads(2*n);
+#pragma omp parallel for reduction (+:u) num_threads(nt) if (nt>1)
+#endif
+            for (int j=0; j<n; ++j) {
+              int done;
+#pragma omp atomic read
+              done=stop;
+              if (j==i || done)
+                continue;
+              double unew=pairpot( a, pnew[j], geometry.sqdist(a,pnew[j]) );
+              if (unew>=pc::infty) {
+#pragma omp atomic write
+                stop=1;
+              }
+              u += unew - pairpot( b, pold[j], geometry.sqdist(b,pold[j]) );
+            }
+            return stop ? pc::infty : u;
+          }
+
           double g2g(const p_vec &p, Group &g1, Group &g2) FOVERRIDE {
             double u=0;
             if (!g1.empty())
@@ -181,32 +296,34 @@ namespace Faunus {
                 if (g1.find(g2.front()))
                   if (g1.find(g2.back())) {  // g2 is a subgroup of g1
                     assert(g1.size()>=g2.size());
-                    for (int i=g1.front(); i<g2.front(); i++)
-                      for (auto j : g2)
-                        u+=pairpot(p[i],p[j],geometry.sqdist(p[i],p[j]));
-                    for (int i=g2.back()+1; i<=g1.back(); i++)
-                      for (auto j : g2)
-                        u+=pairpot(p[i],p[j],geometry.sqdist(p[i],p[j]));
-                    return u;
+                    return outside(p, g2, g1);
                   }
                 if (g2.find(g1.front()))
                   if (g2.find(g1.back())) {  // g1 is a subgroup of g2
                     assert(g2.size()>=g1.size());
-                    for (int i=g2.front(); i<g1.front(); i++)
-                      for (auto j : g1)
-                        u+=pairpot(p[i],p[j],geometry.sqdist(p[i],p[j]));
-                    for (int i=g1.back()+1; i<=g2.back(); i++)
-                      for (auto j : g1)
-                        u+=pairpot(p[i],p[j],geometry.sqdist(p[i],p[j]));
-                    return u;
+                    return outside(p, g1, g2);
                   }
 
                 // IN CASE BOTH GROUPS ARE INDEPENDENT (DEFAULT)
-                int ilen=g1.back()+1, jlen=g2.back()+1;
+                int ilen=g1.back()+1, jlen=g2.back()+1, stop=0;
 #pragma omp parallel for reduction (+:u) schedule (dynamic)
-                for (int i=g1.front(); i<ilen; ++i)
+                for (int i=g1.front(); i<ilen; ++i) {
+                  int done;
+#pragma omp atomic read
+                  done=stop;
+                  if (done)
+                    continue;
+                  double ui=0;
                   for (int j=g2.front(); j<jlen; ++j)
-                    u+=pairpot(p[i],p[j],geometry.sqdist(p[i],p[j]));
+                    ui+=pairpot(p[i],p[j],geometry.sqdist(p[i],p[j]));
+                  if (ui>=pc::infty) {
+#pragma omp atomic write
+                    stop=1;
+                  }
+                  u+=ui;
+                }
+                if (stop)
+                  return pc::infty;
               }
             return u;
           }
@@ -214,14 +331,27 @@ namespace Faunus {
           double g2all(const p_vec &p, Group &g) FOVERRIDE {
             double u=0;
             if (!g.empty()) {
-              int ng=g.back()+1, np=p.size();
+              int ng=g.back()+1, np=p.size(), stop=0;
 #pragma omp parallel for reduction (+:u)
               for (int i=g.front(); i<ng; ++i) {
+                int done;
+#pragma omp atomic read
+                done=stop;
+                if (done)
+                  continue;
+                double ui=0;
                 for (int j=0; j<g.front(); j++)
-                  u += pairpot( p[i], p[j], geometry.sqdist(p[i],p[j]) );
+                  ui += pairpot( p[i], p[j], geometry.sqdist(p[i],p[j]) );
                 for (int j=ng; j<np; j++)
-                  u += pairpot( p[i], p[j], geometry.sqdist(p[i],p[j]) );
+                  ui += pairpot( p[i], p[j], geometry.sqdist(p[i],p[j]) );
+                if (ui>=pc::infty) {
+#pragma omp atomic write
+                  stop=1;
+                }
+                u+=ui;
               }
+              if (stop)
+                return pc::infty;
             }
             return u;
           }
@@ -230,9 +360,12 @@ namespace Faunus {
             double u=0;
             const int b=g.back(), f=g.front();
             if (!g.empty())
-              for (int i=f; i<b; ++i)
+              for (int i=f; i<b; ++i) {
                 for (int j=i+1; j<=b; ++j)
                   u+=pairpot(p[i],p[j],geometry.sqdist(p[i],p[j]));
+                if (u>=pc::infty)
+                  return pc::infty;
+              }
             return u;
           }
 
@@ -243,6 +376,17 @@ namespace Faunus {
                 u+=p2p(i,j);
             return u;
           }
+
+          /**
+           * Calculates the electric field on all particles
+           * and stores (add) in the vector `E`.
+           *
+           * @param p Particle vector
+           * @param E Holds field on each particle. Must be of size N.
+           */
+          void field(const p_vec &p, std::vector<Point> &E) FOVERRIDE {
+            pairField(pairpot, geometry, p, E);
+          }
       };
 
     /**
@@ -410,15 +554,8 @@ namespace Faunus {
            * @param p Particle vector
            * @param E Holds field on each particle. Must be of size N.
            */
-          void field(const p_vec &p, std::vector<Point> &E) {
-            assert(p.size()==E.size());
-            size_t i=0;
-            for (auto &pi : p) {
-              for (auto &pj : p)
-                if (&pi!=&pj)
-                  E[i]+=pairpot.field(pj, geometry.vdist(pi,pj));
-              i++;
-            }
+          void field(const p_vec &p, std::vector<Point> &E) FOVERRIDE {
+            pairField(pairpot, geometry, p, E);
           }
       };
 
@@ -481,6 +618,389 @@ namespace Faunus {
         }
       };
 
+    /**
+     * @brief Nonbonded interactions using a cell list for short ranged pair potentials
+     *
+     * This re-implements the single particle and group energy functions of
+     * `Nonbonded` using a `Geometry::CellList` so that only particles in
+     * neighbouring cells are visited and the cost of, say, `i2all()` is independent
+     * of the system size. Pairs further apart than the cut-off are skipped and
+     * the pair potential must therefore be zero beyond the cut-off as is the case for
+     * for example `Potential::CoulombWolf` and `Potential::LennardJonesTrunkShift`.
+     *
+     * The cell list follows the accepted configuration, `Space::p`, and is updated
+     * incrementally via `trialUpdate()`, `acceptUpdate()` and `rejectUpdate()`
+     * that are called by `Move::Movebase`. If the moved particles are unknown, or
+     * if the volume changes, the full loops in `Nonbonded` are used until the move
+     * is accepted or rejected upon which the cell list is rebuilt.
+     * If particles are modified outside Monte Carlo moves, call `update()`.
+     *
+     * The InputMap is scanned for the following keywords:
+     *
+     * Key                | Description
+     * :----------------- | :-------------------------------------------
+     * `celllist_cutoff`  | Spherical cut-off distance [angstrom]
+     *
+     * Example:
+     *
+     *     Energy::Hamiltonian pot;
+     *     auto nb = pot.create( Energy::NonbondedCellList<Tpairpot,Geometry::Cuboid>(in) );
+     *     Space spc( pot.getGeometry() );
+     *     nb->setSpace(spc);
+     *
+     * @date Lund, 2013
+     */
+    template<class Tpairpot, class Tgeometry>
+      class NonbondedCellList : public Nonbonded<Tpairpot,Tgeometry> {
+        private:
+          typedef Nonbonded<Tpairpot,Tgeometry> Tbase;
+          using Tbase::geometry;
+          using Tbase::pairpot;
+          Space* spcPtr;
+          Geometry::CellList<Tgeometry> cells;
+          double rc2;              //!< Squared cut-off distance
+          bool sync;               //!< True if cell list matches `Space::p`
+          bool intrial;            //!< True between trialUpdate() and accept/rejectUpdate()
+          vector<int> moved;       //!< Particles moved in current trial move
+          vector<char> ismoved;    //!< Moved flag for each particle
+          unsigned long int cnt, cntfull;
+
+          string _info() {
+            using namespace textio;
+            char w=25;
+            std::ostringstream o;
+            o << Tbase::_info()
+              << pad(SUB,w,"Cell list cut-off") << sqrt(rc2) << _angstrom << endl;
+            if (sync) {
+              auto n=cells.numCells();
+              o << pad(SUB,w,"Number of cells")
+                << n.x() << " x " << n.y() << " x " << n.z() << endl;
+            }
+            if (cnt>0)
+              o << pad(SUB,w,"Full evaluation fraction") << cntfull/double(cnt) << endl;
+            return o.str();
+          }
+
+          /** @brief Determines if the cell list can be used for the given particle vector */
+          bool usecells(const p_vec &p) {
+            cnt++;
+            if (spcPtr!=nullptr) {
+              if (!intrial)
+                if (!sync || !cells.valid(geometry, spcPtr->p))
+                  update();
+              if (sync)
+                if (&p==&spcPtr->p || &p==&spcPtr->trial)
+                  return true;
+            }
+            cntfull++;
+            return false;
+          }
+
+          /**
+           * @brief Loop over all particles in cells neighbouring a point
+           *
+           * For the trial vector, moved particles are visited separately as
+           * the cell list is binned according to their old positions.
+           */
+          template<class Tfunc>
+            void forNeighbours(const p_vec &p, const Point &a, Tfunc f) const {
+              bool trial = (&p==&spcPtr->trial && !moved.empty());
+              for (auto c : cells.neighbours( cells.index(a) ))
+                for (auto j : cells[c])
+                  if (!trial || !ismoved[j])
+                    f(j);
+              if (trial)
+                for (auto j : moved)
+                  f(j);
+            }
+
+          inline double pairenergy(const particle &a, const particle &b) {
+            double r2=geometry.sqdist(a,b);
+            return (r2<rc2) ? pairpot(a,b,r2) : 0;
+          }
+
+          void clearMoved() {
+            for (auto i : moved)
+              ismoved[i]=0;
+            moved.clear();
+            intrial=false;
+          }
+
+        public:
+          NonbondedCellList(InputMap &in) : Tbase(in) {
+            double rc = in.get<double>("celllist_cutoff", pc::infty, "Cell list cut-off (AA)");
+            rc2 = rc*rc;
+            cells.setCutoff(rc);
+            Tbase::name+=" (Cell List)";
+            spcPtr=nullptr;
+            sync=intrial=false;
+            cnt=cntfull=0;
+          }
+
+          /** @brief Specify simulation Space. The cell list is built upon first use. */
+          void setSpace(Space &spc) {
+            spcPtr=&spc;
+            sync=false;
+          }
+
+          /** @brief Full rebuild of the cell list from `Space::p` */
+          void update() {
+            assert(spcPtr!=nullptr && "You forgot to set Space.");
+            cells.update(geometry, spcPtr->p);
+            moved.clear();
+            ismoved.assign(spcPtr->p.size(), 0);
+            sync=true;
+          }
+
+          void setVolume(double vol) FOVERRIDE {
+            Tbase::setVolume(vol);
+            sync=false;
+          }
+
+          void trialUpdate(const Space &spc, const Change &c) FOVERRIDE {
+            if (&spc!=spcPtr)
+              return;
+            if (c.all())
+              sync=false;
+            else {
+              if (!sync || !cells.valid(geometry, spcPtr->p))
+                update();
+              for (auto i : c.index) {
+                assert(i>=0 && i<(int)ismoved.size() && "Moved particle out of range");
+                ismoved[i]=1;
+                moved.push_back(i);
+              }
+            }
+            intrial=true;
+          }
+
+          void acceptUpdate(const Change&) FOVERRIDE {
+            if (spcPtr==nullptr)
+              return;
+            if (sync && cells.valid(geometry, spcPtr->p))
+              for (auto i : moved)
+                cells.update(spcPtr->p, i);
+            else
+              sync=false;
+            clearMoved();
+          }
+
+          void rejectUpdate(const Change&) FOVERRIDE {
+            if (spcPtr==nullptr)
+              return;
+            if (!cells.valid(geometry, spcPtr->p))
+              sync=false;
+            clearMoved();
+          }
+
+          double all2p(const p_vec &p, const particle &a) FOVERRIDE {
+            if (!usecells(p))
+              return Tbase::all2p(p,a);
+            double u=0;
+            forNeighbours(p, a, [&](int j) { u+=pairenergy(a,p[j]); } );
+            return u;
+          }
+
+          /** @brief Two neighbour searches if cells are in use, otherwise the fused loop of `Nonbonded` */
+          double i2all_change(const p_vec &pnew, const p_vec &pold, int i) FOVERRIDE {
+            if (!usecells(pnew))
+              return Tbase::i2all_change(pnew,pold,i);
+            return Energybase::i2all_change(pnew,pold,i);
+          }
+
+          double i2all(const p_vec &p, int i) FOVERRIDE {
+            assert(i>=0 && i<int(p.size()) && "index i outside particle vector");
+            if (!usecells(p))
+              return Tbase::i2all(p,i);
+            double u=0;
+            forNeighbours(p, p[i], [&](int j) {
+                if (j!=i) u+=pairenergy(p[i],p[j]); } );
+            return u;
+          }
+
+          double g2g(const p_vec &p, Group &g1, Group &g2) FOVERRIDE {
+            if (g1.empty() || g2.empty())
+              return 0;
+            if (g1.find(g2.front()) || g1.find(g2.back()) || g2.find(g1.front()))
+              return Tbase::g2g(p,g1,g2); // overlapping groups
+            if (!usecells(p))
+              return Tbase::g2g(p,g1,g2);
+            Group &gs = (g1.size()<g2.size()) ? g1 : g2; // loop over smallest
+            Group &gl = (&gs==&g1) ? g2 : g1;            // group
+            double u=0;
+            for (auto i : gs)
+              forNeighbours(p, p[i], [&](int j) {
+                  if (gl.find(j)) u+=pairenergy(p[i],p[j]); } );
+            return u;
+          }
+
+          double g2all(const p_vec &p, Group &g) FOVERRIDE {
+            if (g.empty())
+              return 0;
+            if (!usecells(p))
+              return Tbase::g2all(p,g);
+            double u=0;
+            for (auto i : g)
+              forNeighbours(p, p[i], [&](int j) {
+                  if (!g.find(j)) u+=pairenergy(p[i],p[j]); } );
+            return u;
+          }
+
+          double g_internal(const p_vec &p, Group &g) FOVERRIDE {
+            if (g.empty())
+              return 0;
+            if (!usecells(p))
+              return Tbase::g_internal(p,g);
+            double u=0;
+            for (auto i : g)
+              forNeighbours(p, p[i], [&](int j) {
+                  if (j>i && g.find(j)) u+=pairenergy(p[i],p[j]); } );
+            return u;
+          }
+
+          double v2v(const p_vec &p1, const p_vec &p2) FOVERRIDE {
+            double u=0;
+            for (auto &b : p2)
+              u+=all2p(p1,b);
+            return u;
+          }
+
+          /** @brief Not available as the cut-off does not scale with volume */
+          bool all2all_powers(const p_vec&, std::map<int,double>&) FOVERRIDE { return false; }
+      };
+
+    /**
+     * @brief Nonbonded interactions using structure-of-arrays particle storage
+     *
+     * This uses the `ParticleArrays` mirrors of `Space::p` and `Space::trial` for
+     * single particle and group energies: for each particle, squared distances
+     * to a contiguous range of particles are first calculated by the geometry and
+     * then handed to the pair potential's `batch()` function. Both loops are
+     * free of branches and only touch the properties needed, so that they are
+     * vectorized by the compiler. The final summation uses Eigen's packet math.
+     *
+     * Only pair potentials for which `Potential::has_batch` is true are supported
+     * (`Coulomb`, `DebyeHuckel`, `LennardJones` and combinations thereof)
+     * while the geometry must provide a batched `sqdist()` which is the case for
+     * `Sphere`, `Cylinder`, `PeriodicCylinder`, `Cuboid` and `Cuboidslit`.
+     * If the arrays are unavailable, the loops in `Nonbonded` are used.
+     *
+     * Example:
+     *
+     *     Energy::Hamiltonian pot;
+     *     auto nb = pot.create( Energy::NonbondedArrays<Tpairpot,Geometry::Cuboid>(in) );
+     *     Space spc( pot.getGeometry() );
+     *     nb->setSpace(spc); // enables Space arrays
+     *
+     * @date Lund, 2013
+     */
+    template<class Tpairpot, class Tgeometry>
+      class NonbondedArrays : public Nonbonded<Tpairpot,Tgeometry> {
+        private:
+          typedef Nonbonded<Tpairpot,Tgeometry> Tbase;
+          using Tbase::geometry;
+          using Tbase::pairpot;
+          Space* spcPtr;
+          Eigen::ArrayXd r2buf, ubuf;   // work arrays
+
+          /** @brief Energy of `a` with particles in range [first,last[ */
+          double kernel(const particle &a, const ParticleArrays &b, int first, int last) {
+            int n=last-first;
+            if (n<=0)
+              return 0;
+            if (r2buf.size()<n) {
+              r2buf.resize(n);
+              ubuf.resize(n);
+            }
+            geometry.sqdist(a, &b.x[first], &b.y[first], &b.z[first], r2buf.data(), n);
+            ubuf.head(n).setZero();
+            pairpot.batch(a, b, first, n, r2buf.data(), ubuf.data());
+            return ubuf.head(n).sum();
+          }
+
+          const ParticleArrays* arrays(const p_vec &p) const {
+            return (spcPtr==nullptr) ? nullptr : spcPtr->arrays(p);
+          }
+
+        public:
+          NonbondedArrays(InputMap &in) : Tbase(in), spcPtr(nullptr) {
+            static_assert( Potential::has_batch<Tpairpot>::value,
+                "Pair potential has no batch() function" );
+            Tbase::name+=" (SoA)";
+          }
+
+          /** @brief Specify simulation Space and enable its particle arrays */
+          void setSpace(Space &spc) {
+            spcPtr=&spc;
+            spc.enableArrays();
+          }
+
+          double all2p(const p_vec &p, const particle &a) FOVERRIDE {
+            auto b=arrays(p);
+            if (b==nullptr)
+              return Tbase::all2p(p,a);
+            return kernel(a, *b, 0, p.size());
+          }
+
+          /** @brief Two vectorized `i2all()` evaluations rather than the fused scalar loop of `Nonbonded` */
+          double i2all_change(const p_vec &pnew, const p_vec &pold, int i) FOVERRIDE {
+            return Energybase::i2all_change(pnew,pold,i);
+          }
+
+          double i2all(const p_vec &p, int i) FOVERRIDE {
+            assert(i>=0 && i<int(p.size()) && "index i outside particle vector");
+            auto b=arrays(p);
+            if (b==nullptr)
+              return Tbase::i2all(p,i);
+            return kernel(p[i], *b, 0, i) + kernel(p[i], *b, i+1, p.size());
+          }
+
+          double i2g(const p_vec &p, Group &g, int j) FOVERRIDE {
+            auto b=arrays(p);
+            if (b==nullptr || g.empty())
+              return Tbase::i2g(p,g,j);
+            if (g.find(j))
+              return kernel(p[j], *b, g.front(), j) + kernel(p[j], *b, j+1, g.back()+1);
+            return kernel(p[j], *b, g.front(), g.back()+1);
+          }
+
+          double g2g(const p_vec &p, Group &g1, Group &g2) FOVERRIDE {
+            if (g1.empty() || g2.empty())
+              return 0;
+            auto b=arrays(p);
+            if (b==nullptr || g1.find(g2.front()) || g1.find(g2.back()) || g2.find(g1.front()))
+              return Tbase::g2g(p,g1,g2); // overlapping groups
+            double u=0;
+            for (auto i : g1)
+              u+=kernel(p[i], *b, g2.front(), g2.back()+1);
+            return u;
+          }
+
+          double g2all(const p_vec &p, Group &g) FOVERRIDE {
+            if (g.empty())
+              return 0;
+            auto b=arrays(p);
+            if (b==nullptr)
+              return Tbase::g2all(p,g);
+            double u=0;
+            for (auto i : g)
+              u+=kernel(p[i], *b, 0, g.front()) + kernel(p[i], *b, g.back()+1, p.size());
+            return u;
+          }
+
+          double g_internal(const p_vec &p, Group &g) FOVERRIDE {
+            if (g.empty())
+              return 0;
+            auto b=arrays(p);
+            if (b==nullptr)
+              return Tbase::g_internal(p,g);
+            double u=0;
+            for (auto i : g)
+              u+=kernel(p[i], *b, i+1, g.back()+1);
+            return u;
+          }
+      };
+
     /**
      * @brief Energy class for hard-sphere overlap.
      */
@@ -536,36 +1056,104 @@ namespace Faunus {
      *     Energy::Bonded b;
      *     b.add(i, j, Potential::Harmonic(0.1,5.0) );
      *     std::cout << b.info();
-     *     double rij2 = ... ;                 // squared distance between i and j
-     *     double u = b(i,j)( p[i], p[j], rij2 ); // i j bond energy in kT
+     *     double u = b.i2i(p, i, j);          // i j bond energy in kT
+     *
+     * Bonds are stored in a contiguous list and a compressed sparse row (CSR)
+     * table holds the bond partners of each particle, so that looping over the
+     * bonds of a particle or a group touches only consecutive memory.
+     * `Potential::Harmonic` and `Potential::FENE` bonds are evaluated directly
+     * while any other pair potential is wrapped in a `std::function` which is
+     * slower. Each pair of particles should be bonded only once.
      *
-     * @date Lund, 2011-2012
+     * When particles are inserted or removed from `Space`, call `insert()` or
+     * `erase()` with the same index to keep the bond indices valid.
+     *
+     * @date Lund, 2011-2014
      */
-    class Bonded : public Energybase,
-    protected pair_list<std::function<double(const particle&,const particle&,double)> > {
+    class Bonded : public Energybase {
       private:
-        typedef pair_list<std::function<double(const particle&,const particle&,double)> > Tbase;
-        string _info(), _infolist;
+        typedef std::function<double(const particle&,const particle&,double)> Tfunc;
+        enum Tkind {HARMONIC, FENE, GENERIC};
+
+        struct Bond {
+          int i, j;   //!< Bonded particle indices
+          Tkind kind; //!< Bond type
+          int index;  //!< Position in the potential vector of the given type
+        };
+
+        struct Partner {
+          int j;      //!< Partner particle index
+          int bond;   //!< Position in bond list
+        };
+
+        vector<Bond> bonds;                 //!< All bonds
+        vector<string> briefs;              //!< Bond description (same order as `bonds`)
+        vector<Potential::Harmonic> harmonic;
+        vector<Potential::FENE> fene;
+        vector<Tfunc> generic;
+        vector<int> offset;                 //!< CSR offsets - partners of i are in `[offset[i]:offset[i+1][`
+        vector<Partner> partners;           //!< CSR partner list
+        std::map<std::pair<int,int>,int> lookup; //!< Position in bond list for each pair `(i<j)`
+        bool dirty;                         //!< True if CSR table must be rebuilt
+
+        string _info();
+        void build();                       //!< Rebuild CSR table from bond list
+        void reindex();                     //!< Rebuild `lookup` from bond list
+        void add(int, int, Tkind, int, const string&);
+
+        template<class T>
+          void compact(vector<T>&, Tkind);  //!< Remove potentials of given type not used by any bond
+
+        inline double energy(const Bond &b, const particle &a1, const particle &a2, double r2) {
+          switch (b.kind) {
+            case HARMONIC: return harmonic[b.index](a1,a2,r2);
+            case FENE:     return fene[b.index](a1,a2,r2);
+            default:       return generic[b.index](a1,a2,r2);
+          }
+        }
+
+        inline double energy(const p_vec &p, int i, const Partner &n) {
+          return energy( bonds[n.bond], p[i], p[n.j], geo->sqdist( p[i], p[n.j] ) );
+        }
+
+        /** @brief Range of partners to particle i */
+        inline std::pair<const Partner*,const Partner*> partnersOf(int i) {
+          if (dirty)
+            build();
+          if (i+1>=(int)offset.size())
+            return {nullptr,nullptr};
+          const Partner* d=partners.data();
+          return {d+offset[i], d+offset[i+1]};
+        }
+
       public:
         Bonded();
         Bonded(Geometry::Geometrybase&);
         double i2i(const p_vec&, int, int) FOVERRIDE;      //!< Bond energy i with j
         double i2all(const p_vec&, int) FOVERRIDE;         //!< All bonds w. i'th particle
+        double i2g(const p_vec&, Group&, int) FOVERRIDE;   //!< Bonds between i'th particle and group
         double g_internal(const p_vec&, Group&) FOVERRIDE; //!< Internal bonds in Group, only
         double g2g(const p_vec&, Group&, Group&) FOVERRIDE;//!< Bonds between groups
         double total(const p_vec&);                        //!< Sum all known bond energies
         bool CrossGroupBonds; //!< Set to true if bonds cross groups (slower!). Default: false
 
+        void add(int, int, Potential::Harmonic);           //!< Add harmonic bond
+        void add(int, int, Potential::FENE);               //!< Add FENE bond
+
+        /** @brief Add bond with arbitrary pair potential */
         template<class Tpairpot>
           void add(int i, int j, Tpairpot pot) {
-            std::ostringstream o;
-            o << textio::indent(textio::SUBSUB) << std::left << setw(7) << i
-              << setw(7) << j << pot.brief() + "\n";
-            _infolist += o.str();
+            string brief=pot.brief();
             pot.name.clear();   // potentially save a
             pot.prefix.clear(); // little bit of memory
-            Tbase::add(i,j,pot);// create and add functor to pair list
+            generic.push_back(pot);
+            add(i, j, GENERIC, generic.size()-1, brief);
           }
+
+        void insert(int, int=1);  //!< Shift indices for `n` particles inserted at position `i`
+        void erase(int);          //!< Remove bonds to particle `i` and shift subsequent indices
+        int size() const;         //!< Number of bonds
+        void clear();             //!< Remove all bonds
     };
 
     /**
@@ -593,6 +1181,7 @@ namespace Faunus {
         ExternalPressure(Geometry::Geometrybase&, double);
         double external() FOVERRIDE;  //!< External energy working on system. pV/kT-lnV
         double g_external(const p_vec&, Group&) FOVERRIDE; //!< External energy working on group
+        bool all2all_powers(const p_vec&, std::map<int,double>&) FOVERRIDE { return true; } //!< No pair energy
     };
 
     /**
@@ -626,6 +1215,7 @@ namespace Faunus {
         std::vector<Group*> groups;              //!< List of groups to restrict
         RestrictedVolume(InputMap&, string="vconstrain"); //!< Constructor
         double g_external(const p_vec&, Group&) FOVERRIDE; //!< External energy working on group
+        bool all2all_powers(const p_vec&, std::map<int,double>&) FOVERRIDE { return true; } //!< No pair energy
     };
 
     /**
@@ -639,6 +1229,47 @@ namespace Faunus {
         double i_external(const p_vec&, int);              //!< External energy working on single particle
     };
 
+    /**
+     * @brief Cache of group-group energies
+     *
+     * Stores the `g2g()` energy between all pairs of groups in
+     * `Space::groupList()` for the current configuration, `Space::p`.
+     * Moves of a single group, such as `Move::TranslateRotate`, can
+     * then look up the old energy row with `row()` and only
+     * evaluate the new row, `trialRow()`, which is swapped in upon acceptance.
+     * The cache listens to the trial/accept/reject hooks of its Hamiltonian
+     * and rows of groups touched by other moves are lazily recalculated.
+     * Moves that change all particles, the volume or the number of particles
+     * (see `Change::all()`) invalidate the whole matrix.
+     *
+     * The cache is opt-in and is enabled with `Hamiltonian::enableGroupCache()`.
+     * It is also invalidated whenever the state of `Space` is replaced by
+     * `Space::load()`, including restarts from a `Checkpoint`.
+     */
+    class GroupPairCache {
+      private:
+        Space* spc;
+        Energybase* pot;
+        Eigen::MatrixXd u;     //!< Group-group energies of Space::p
+        Eigen::VectorXd utrial;//!< Trial energies of moved group with all other groups
+        vector<bool> stale;    //!< Rows that need recalculation
+        int trialrow;          //!< Group index of `utrial` (-1 if none)
+        bool intrial;
+        unsigned int nload;    //!< `Space::loadCount()` when last refreshed
+        void refresh();        //!< Recalculate stale rows
+        int groupIndex(const Group&);
+      public:
+        GroupPairCache(Space&, Energybase&);
+        double row(Group&);                     //!< Energy of group with all other groups
+        double trialRow(const p_vec&, Group&);  //!< Trial energy of group with all other groups
+        double g2g(Group&, Group&);             //!< Cached energy between two groups
+        double total();                         //!< Sum of all group-group energies
+        void invalidate();                      //!< Recalculate all energies upon next use
+        void trialUpdate(const Change&);
+        void acceptUpdate(const Change&);
+        void rejectUpdate(const Change&);
+    };
+
     /**
      * @brief Collection of Energybases that when summed give the Hamiltonian
      *
@@ -655,6 +1286,8 @@ namespace Faunus {
      * Notice that we do not need to specify a Geometry for the Bonded energy class as this information
      * is simply passed on from the first added potential.
      *
+     * Summation over the energy classes stops as soon as the energy becomes infinite.
+     *
      * \author Mikael Lund
      * @date Lund, 2011
      */
@@ -664,6 +1297,7 @@ namespace Faunus {
       vector<baseptr> created;      //!< smart pointer list of *created* energy classes
       string _info();
       vector<Energybase*> baselist; //!< Pointer list to energy classes to be summed
+      shared_ptr<GroupPairCache> gcache; //!< Group-group energy cache (if enabled)
       public:
       Hamiltonian();
       void setVolume(double);       //!< Set volume of all contained energy classes
@@ -693,6 +1327,8 @@ namespace Faunus {
       }
 
       void add(Energybase&); //!< Add existing energy class to list
+      void enableGroupCache(Space&); //!< Cache group-group energies of all groups in Space
+      inline GroupPairCache* groupCache() { return gcache.get(); } //!< Group energy cache (nullptr if disabled)
       double p2p(const particle&, const particle&) FOVERRIDE;
       Point f_p2p(const particle&, const particle&) FOVERRIDE;
       double all2p(const p_vec&, const particle&) FOVERRIDE;
@@ -700,6 +1336,7 @@ namespace Faunus {
       double i2i(const p_vec&, int, int) FOVERRIDE;
       double i2g(const p_vec&, Group&, int) FOVERRIDE;
       double i2all(const p_vec&, int) FOVERRIDE;
+      double i2all_change(const p_vec&, const p_vec&, int) FOVERRIDE;
       double i_external(const p_vec&, int) FOVERRIDE;
       double i_internal(const p_vec&, int) FOVERRIDE;
       double g2g(const p_vec&, Group&, Group&) FOVERRIDE;
@@ -708,7 +1345,11 @@ namespace Faunus {
       double g_internal(const p_vec&, Group&) FOVERRIDE;
       double external() FOVERRIDE;
       double v2v(const p_vec&, const p_vec&) FOVERRIDE;
+      bool all2all_powers(const p_vec&, std::map<int,double>&) FOVERRIDE;
       void field(const p_vec&, std::vector<Point>&) FOVERRIDE;
+      void trialUpdate(const Space&, const Change&) FOVERRIDE;
+      void acceptUpdate(const Change&) FOVERRIDE;
+      void rejectUpdate(const Change&) FOVERRIDE;
     };
 
     template<class T1, class T2>
@@ -735,6 +1376,9 @@ namespace Faunus {
         double i2i(const p_vec &p, int i, int j) FOVERRIDE { return first.i2i(p,i,j)+second.i2i(p,i,j); }
         double i2g(const p_vec &p, Group &g, int i) FOVERRIDE { return first.i2g(p,g,i)+second.i2g(p,g,i); }
         double i2all(const p_vec &p , int i) FOVERRIDE { return first.i2all(p,i)+second.i2all(p,i); }
+        double i2all_change(const p_vec &pn, const p_vec &po, int i) FOVERRIDE {
+          return first.i2all_change(pn,po,i)+second.i2all_change(pn,po,i);
+        }
         double i_external(const p_vec&p, int i) FOVERRIDE { return first.i_external(p,i)+second.i_external(p,i); }
         double i_internal(const p_vec&p, int i) FOVERRIDE { return first.i_internal(p,i)+second.i_internal(p,i); }
         double g2g(const p_vec&p, Group&g1, Group&g2) FOVERRIDE { return first.g2g(p,g1,g2)+second.g2g(p,g1,g2); }
@@ -743,10 +1387,264 @@ namespace Faunus {
         double g_internal(const p_vec&p, Group&g) FOVERRIDE { return first.g_internal(p,g)+second.g_internal(p,g); }
         double external() FOVERRIDE { return first.external()+second.external(); }
         double v2v(const p_vec&p1, const p_vec&p2) FOVERRIDE { return first.v2v(p1,p2)+second.v2v(p1,p2); }
+        bool all2all_powers(const p_vec&p, std::map<int,double>&m) FOVERRIDE {
+          return first.all2all_powers(p,m) && second.all2all_powers(p,m);
+        }
         void field(const p_vec&p, std::vector<Point>&E) FOVERRIDE { first.field(p,E); second.field(p,E); }
+        void trialUpdate(const Space &s, const Change &c) FOVERRIDE { first.trialUpdate(s,c); second.trialUpdate(s,c); }
+        void acceptUpdate(const Change &c) FOVERRIDE { first.acceptUpdate(c); second.acceptUpdate(c); }
+        void rejectUpdate(const Change &c) FOVERRIDE { first.rejectUpdate(c); second.rejectUpdate(c); }
       };
 
 
+    /**
+     * @brief Compile-time list of energy terms
+     *
+     * Sums the energy functions of the terms which are called with qualified
+     * (non-virtual) calls and may thus be inlined. Used by `StaticHamiltonian`.
+     */
+    template<class... Tterms>
+      struct StaticTerms {
+        string names() { return ""; }
+        string info() { return ""; }
+        void setGeometry(Geometry::Geometrybase&) {}
+        void setVolume(double) {}
+        double p2p(const particle&, const particle&) { return 0; }
+        Point f_p2p(const particle&, const particle&) { return Point(0,0,0); }
+        double all2p(const p_vec&, const particle&) { return 0; }
+        double all2all(const p_vec&) { return 0; }
+        double i2i(const p_vec&, int, int) { return 0; }
+        double i2g(const p_vec&, Group&, int) { return 0; }
+        double i2all(const p_vec&, int) { return 0; }
+        double i2all_change(const p_vec&, const p_vec&, int) { return 0; }
+        double i_external(const p_vec&, int) { return 0; }
+        double i_internal(const p_vec&, int) { return 0; }
+        double p_external(const particle&) { return 0; }
+        double g2g(const p_vec&, Group&, Group&) { return 0; }
+        double g2all(const p_vec&, Group&) { return 0; }
+        double g_external(const p_vec&, Group&) { return 0; }
+        double g_internal(const p_vec&, Group&) { return 0; }
+        double v2v(const p_vec&, const p_vec&) { return 0; }
+        double external() { return 0; }
+        bool all2all_powers(const p_vec&, std::map<int,double>&) { return true; }
+        void field(const p_vec&, std::vector<Point>&) {}
+        void trialUpdate(const Space&, const Change&) {}
+        void acceptUpdate(const Change&) {}
+        void rejectUpdate(const Change&) {}
+      };
+
+    template<class T, class... Tterms>
+      struct StaticTerms<T,Tterms...> {
+        static_assert( std::is_base_of<Energybase,T>::value, "Terms must derive from Energybase" );
+        T first;
+        StaticTerms<Tterms...> rest;
+
+        StaticTerms(const T &t, const Tterms&... r) : first(t), rest(r...) {}
+
+        string names() { return ", " + first.name + rest.names(); }
+        string info() { return first.info() + rest.info(); }
+        void setGeometry(Geometry::Geometrybase &g) { first.setGeometry(g); rest.setGeometry(g); }
+        void setVolume(double V) { first.T::setVolume(V); rest.setVolume(V); }
+
+        double p2p(const particle &a, const particle &b) { return first.T::p2p(a,b)+rest.p2p(a,b); }
+        Point f_p2p(const particle &a, const particle &b) { return first.T::f_p2p(a,b)+rest.f_p2p(a,b); }
+        double all2p(const p_vec &p, const particle &a) { return first.T::all2p(p,a)+rest.all2p(p,a); }
+        double all2all(const p_vec &p) { return first.T::all2all(p)+rest.all2all(p); }
+        double i2i(const p_vec &p, int i, int j) { return first.T::i2i(p,i,j)+rest.i2i(p,i,j); }
+        double i2g(const p_vec &p, Group &g, int i) { return first.T::i2g(p,g,i)+rest.i2g(p,g,i); }
+        double i2all(const p_vec &p, int i) { return first.T::i2all(p,i)+rest.i2all(p,i); }
+        double i2all_change(const p_vec &pn, const p_vec &po, int i) {
+          return first.T::i2all_change(pn,po,i)+rest.i2all_change(pn,po,i);
+        }
+        double i_external(const p_vec &p, int i) { return first.T::i_external(p,i)+rest.i_external(p,i); }
+        double i_internal(const p_vec &p, int i) { return first.T::i_internal(p,i)+rest.i_internal(p,i); }
+        double p_external(const particle &a) { return first.T::p_external(a)+rest.p_external(a); }
+        double g2g(const p_vec &p, Group &g1, Group &g2) { return first.T::g2g(p,g1,g2)+rest.g2g(p,g1,g2); }
+        double g2all(const p_vec &p, Group &g) { return first.T::g2all(p,g)+rest.g2all(p,g); }
+        double g_external(const p_vec &p, Group &g) { return first.T::g_external(p,g)+rest.g_external(p,g); }
+        double g_internal(const p_vec &p, Group &g) { return first.T::g_internal(p,g)+rest.g_internal(p,g); }
+        double v2v(const p_vec &p1, const p_vec &p2) { return first.T::v2v(p1,p2)+rest.v2v(p1,p2); }
+        double external() { return first.T::external()+rest.external(); }
+        bool all2all_powers(const p_vec &p, std::map<int,double> &m) {
+          return first.T::all2all_powers(p,m) && rest.all2all_powers(p,m);
+        }
+        void field(const p_vec &p, std::vector<Point> &E) { first.T::field(p,E); rest.field(p,E); }
+        void trialUpdate(const Space &s, const Change &c) { first.T::trialUpdate(s,c); rest.trialUpdate(s,c); }
+        void acceptUpdate(const Change &c) { first.T::acceptUpdate(c); rest.acceptUpdate(c); }
+        void rejectUpdate(const Change &c) { first.T::rejectUpdate(c); rest.rejectUpdate(c); }
+      };
+
+    /** @brief Access the `I`th term of a `StaticTerms` list */
+    template<size_t I, class Tlist>
+      struct StaticTermsGet;
+
+    template<class T, class... Tterms>
+      struct StaticTermsGet<0,StaticTerms<T,Tterms...> > {
+        typedef T type;
+        static type& get(StaticTerms<T,Tterms...> &s) { return s.first; }
+      };
+
+    template<size_t I, class T, class... Tterms>
+      struct StaticTermsGet<I,StaticTerms<T,Tterms...> > {
+        typedef StaticTermsGet<I-1,StaticTerms<Tterms...> > Tnext;
+        typedef typename Tnext::type type;
+        static type& get(StaticTerms<T,Tterms...> &s) { return Tnext::get(s.rest); }
+      };
+
+    /**
+     * @brief Hamiltonian composed at compile time
+     *
+     * This is an alternative to `Hamiltonian` where the energy terms are
+     * given as template parameters. All pair interactions are described by
+     * a single pair potential, `Tpairpot`, and are evaluated in one pass over
+     * particle pairs exactly as in `Nonbonded`. Several pair potentials can be
+     * fused into one with `Potential::CombinedPairPotential` (i.e. `pot1+pot2`).
+     * Remaining terms, `Tterms`, such as `Bonded` or `ExternalPotential`
+     * are copied into the Hamiltonian and called without virtual dispatch. All
+     * terms share the geometry of the Hamiltonian.
+     *
+     * The `Energybase` interface is kept so that the class can be used with
+     * any Markov move. Example:
+     *
+     * ~~~~
+     * typedef Potential::CoulombHS Tpairpot;
+     * Energy::StaticHamiltonian<Tpairpot,Geometry::Cuboid,Energy::Bonded> pot(mcp, Energy::Bonded());
+     * pot.term<0>().add(0, 1, Potential::Harmonic(0.5,5.0));
+     * Space spc( pot.getGeometry() );
+     * Move::AtomicTranslation mv(mcp, pot, spc);
+     * ~~~~
+     *
+     * @date Lund, 2014
+     */
+    template<class Tpairpot, class Tgeometry, class... Tterms>
+      class StaticHamiltonian : public Nonbonded<Tpairpot,Tgeometry> {
+        private:
+          typedef Nonbonded<Tpairpot,Tgeometry> base;
+          typedef StaticTerms<Tterms...> Tlist;
+          Tlist terms;
+
+          string _info() {
+            return base::_info() + terms.info();
+          }
+
+          void init() {
+            this->name="Static Hamiltonian - " + this->pairpot.name + terms.names();
+            terms.setGeometry( this->getGeometry() );
+          }
+
+        public:
+          StaticHamiltonian(InputMap &in, const Tterms&... t) : base(in), terms(t...) {
+            init();
+          }
+
+          StaticHamiltonian(const StaticHamiltonian &o) : base(o), terms(o.terms) {
+            init();
+          }
+
+          /** @brief Access the `I`th term (not counting pair interactions) */
+          template<size_t I>
+            typename StaticTermsGet<I,Tlist>::type& term() {
+              return StaticTermsGet<I,Tlist>::get(terms);
+            }
+
+          void setVolume(double V) FOVERRIDE {
+            base::setVolume(V);
+            terms.setVolume(V);
+          }
+
+          double p2p(const particle &a, const particle &b) FOVERRIDE {
+            return base::p2p(a,b) + terms.p2p(a,b);
+          }
+
+          Point f_p2p(const particle &a, const particle &b) FOVERRIDE {
+            return base::f_p2p(a,b) + terms.f_p2p(a,b);
+          }
+
+          double all2p(const p_vec &p, const particle &a) FOVERRIDE {
+            return base::all2p(p,a) + terms.all2p(p,a);
+          }
+
+          double all2all(const p_vec &p) FOVERRIDE {
+            return base::all2all(p) + terms.all2all(p);
+          }
+
+          double i2i(const p_vec &p, int i, int j) FOVERRIDE {
+            return base::i2i(p,i,j) + terms.i2i(p,i,j);
+          }
+
+          double i2g(const p_vec &p, Group &g, int i) FOVERRIDE {
+            return base::i2g(p,g,i) + terms.i2g(p,g,i);
+          }
+
+          double i2all(const p_vec &p, int i) FOVERRIDE {
+            return base::i2all(p,i) + terms.i2all(p,i);
+          }
+
+          double i2all_change(const p_vec &pn, const p_vec &po, int i) FOVERRIDE {
+            return base::i2all_change(pn,po,i) + terms.i2all_change(pn,po,i);
+          }
+
+          double i_external(const p_vec &p, int i) FOVERRIDE {
+            return terms.i_external(p,i);
+          }
+
+          double i_internal(const p_vec &p, int i) FOVERRIDE {
+            return terms.i_internal(p,i);
+          }
+
+          double p_external(const particle &a) FOVERRIDE {
+            return terms.p_external(a);
+          }
+
+          double g2g(const p_vec &p, Group &g1, Group &g2) FOVERRIDE {
+            return base::g2g(p,g1,g2) + terms.g2g(p,g1,g2);
+          }
+
+          double g2all(const p_vec &p, Group &g) FOVERRIDE {
+            return base::g2all(p,g) + terms.g2all(p,g);
+          }
+
+          double g_external(const p_vec &p, Group &g) FOVERRIDE {
+            return terms.g_external(p,g);
+          }
+
+          double g_internal(const p_vec &p, Group &g) FOVERRIDE {
+            return base::g_internal(p,g) + terms.g_internal(p,g);
+          }
+
+          double v2v(const p_vec &p1, const p_vec &p2) FOVERRIDE {
+            return base::v2v(p1,p2) + terms.v2v(p1,p2);
+          }
+
+          double external() FOVERRIDE {
+            return terms.external();
+          }
+
+          bool all2all_powers(const p_vec &p, std::map<int,double> &m) FOVERRIDE {
+            return base::all2all_powers(p,m) && terms.all2all_powers(p,m);
+          }
+
+          void field(const p_vec &p, std::vector<Point> &E) FOVERRIDE {
+            base::field(p,E);
+            terms.field(p,E);
+          }
+
+          void trialUpdate(const Space &s, const Change &c) FOVERRIDE {
+            base::trialUpdate(s,c);
+            terms.trialUpdate(s,c);
+          }
+
+          void acceptUpdate(const Change &c) FOVERRIDE {
+            base::acceptUpdate(c);
+            terms.acceptUpdate(c);
+          }
+
+          void rejectUpdate(const Change &c) FOVERRIDE {
+            base::rejectUpdate(c);
+            terms.rejectUpdate(c);
+          }
+      };
+
     /**
      * @brief Constrain two group mass centra within a certain distance interval [mindist:maxdist]
      * \author Mikael Lund
@@ -778,6 +1676,7 @@ namespace Faunus {
         MassCenterConstrain(Geometry::Geometrybase&);      //!< Constructor
         void addPair(Group&, Group&, double, double);      //!< Add constraint between two groups
         double g_external(const p_vec&, Group&) FOVERRIDE; //!< Constrain treated as external potential
+        bool all2all_powers(const p_vec&, std::map<int,double>&) FOVERRIDE { return true; } //!< No pair energy
     };
 
     /**
@@ -796,6 +1695,7 @@ namespace Faunus {
         EnergyRest();
         void add(double du); //!< Add energy change disrepancy, dU = U(metropolis) - U(as in drift calculation)
         double external() FOVERRIDE;  //!< Dumme rest treated as external potential to whole system
+        bool all2all_powers(const p_vec&, std::map<int,double>&) FOVERRIDE { return true; } //!< No pair energy
     };
 
     /**
@@ -826,6 +1726,7 @@ namespace Faunus {
               u+=p_external(p[i]);
             return u;
           }
+          bool all2all_powers(const p_vec&, std::map<int,double>&) FOVERRIDE { return true; } //!< No pair energy
       };
 
     /**
@@ -1,364 +1,997 @@
 #ifndef FAUNUS_EWALD_H
 #define FAUNUS_EWALD_H
 
-/*!
- * @brief Ewald Summation for long-ranged electrostatics
- *
- * Energies are calculated using Ewald
- * the class also contains a optimization concerning
- * cutoff in the Fourier room
- * Cutoff in realspace is set equal to half the box
- *
- * @author Martin Trulsson
- */
-
-#include "faunus/inputfile.h"
+#include <faunus/common.h>
+#include <faunus/energy.h>
+#include <faunus/fft.h>
 #include <complex>
+#include <stdexcept>
 
 namespace Faunus {
 
-  template<typename T=double>
-    class Ewald {
-      private:
-        T a1,a2,a3,a4,a5,p1;
-        T boxlen, halfboxlen;
-        T lB; // Bjerrum length (AA)
-        T twopi;
-        T ewaldpres;
-        T alpha; 
-        T alphasqrt;
-        T pisqrt;
-        T Ewapre;
-        T rcut2;   // Squared real space cut-off
-        int totk;
-        vector<T> kvec;
-        vector<complex<T> > eikr, eikrold;
-        vector< vector< complex<T> > > eix, eiy, eiz, eixold, eiyold, eizold;
-        int kmax, ksqmax;
-        void kSpaceInit();//< initialize k-Space
-
-      public:
-        Ewald(InputMap&, std::string="ewald_");
-        string info();
-
-        void setVolume(T);
-
-        void store() {
-          eikrold = eikr;
-          eixold  = eix;
-          eiyold  = eiy;
-          eizold  = eiz;
-        }
-
-        void restore() {
-          swap(eikr,eikrold);
-          swap(eix,eixold);
-          swap(eiy,eiyold);
-          swap(eiz,eizold);
-        }
-
-        /** @brief Real-space particle-particle energy */
-        T rSpaceEnergy(T, T);
-
-        /** @brief Update k-vectors */
-        template<class Tpvec>
-          void kSpaceUpdate(const Tpvec&);
-
-        /** @brief Update k-vectors */
-        template<class Tpvec>
-          void kSpaceUpdate(const Tpvec&, int);
-
-        /** @brief k-space energy */
-        template<class Tpvec>
-          T kSpaceEnergy(const Tpvec&);
-
-        /** @brief k-space energy */
-        template<class Tpvec>
-          T kSpaceEnergy(const Tpvec&, int);
-
-        template<class Tpvec>
-          T selfEwald(const Tpvec&);            //< Self-Interaction
-
-        /** @brief Optimize alpha */
-        void calcAlpha(int, T=0.001);
-    };
-
-  template<class T>
-    void Ewald<T>::kSpaceInit() {
-      int ksq;
-      T b;
-      T rkx,rky,rkz;
-      T rksq;
-      b=1./4./alpha;
-      T twopii=twopi/boxlen;
-      T vol=pow(boxlen,3);
-      totk=0;
-
-      for (int kx=0; kx<(kmax+1); kx++) {      // uses symmetry
-        rkx = twopii*T(kx);
-        for (int ky=-kmax; ky<(kmax+1); ky++) {
-          rky = twopii*T(ky);
-          for (int kz=-kmax; kz<(kmax+1); kz++) {
-            rkz = twopii*T(kz);
-            ksq = kx*kx+ky*ky+kz*kz;
-            if (ksq < ksqmax && ksq!=0) {
-              totk+=1;
-              assert(totk<=2000 && "K vector too small");
-              rksq = rkx*rkx + rky*rky + rkz*rkz;
-              kvec.push_back( twopi * exp( -b*rksq ) / rksq / vol );
+  namespace Energy {
+
+    /**
+     * @brief Ewald summation for long-ranged electrostatics
+     *
+     * This adds the reciprocal space part of the Ewald summation to the
+     * real space interactions in `Nonbonded`. `Tpairpot` should therefore
+     * include `Potential::CoulombEwald` that uses the same damping parameter,
+     * for example:
+     *
+     *     typedef Potential::CombinedPairPotential<Potential::CoulombEwald,Potential::LennardJones> Tpairpot;
+     *     Energy::Hamiltonian pot;
+     *     auto nb = pot.create( Energy::NonbondedEwald<Tpairpot,Geometry::Cuboid>(in) );
+     *     Space spc( pot.getGeometry() );
+     *     nb->setSpace(spc);
+     *
+     * The reciprocal energy,
+     * @f[
+     * \beta U = \frac{2\pi\lambda_B}{V}\sum_{\bf k\neq 0}
+     * \frac{e^{-k^2/4\alpha^2}}{k^2} \left | Q({\bf k}) \right |^2, \quad
+     * Q({\bf k}) = \sum_j z_j e^{i{\bf k}\cdot{\bf r}_j}
+     * @f]
+     * is a sum of periodic pair interactions and is here evaluated
+     * through structure factors, \f$Q\f$, of particles, groups and the whole system
+     * so that all the usual pair-wise energy functions (`i2all()`, `g2g()`,
+     * `g_internal()` etc.) are available. Self terms that do not depend on
+     * positions, but on the volume, are returned by `external()`.
+     * The k-vectors are stored in a flat list using the
+     * \f${\bf k}\leftrightarrow -{\bf k}\f$ symmetry and are generated for the
+     * (possibly rectangular) box of the `Geometry::Cuboid`.
+     *
+     * The structure factor of `Space::p` is stored and, when moves report which
+     * particles were changed (see `trialUpdate()`), the trial structure factor
+     * is found by adding the change caused by the moved particles only.
+     * This delta is the only thing stored during a trial move: on accept
+     * it is added to the stored structure factor, and on reject it is discarded.
+     * Single particle energies thus scale with the number of k-vectors only.
+     * If particles are modified outside Monte Carlo moves, call `update()`.
+     *
+     * The InputMap is scanned for the following keywords:
+     *
+     * Key            | Description
+     * :------------- | :--------------------------------------------------
+     * `ewald_alpha`  | Damping parameter, \f$\alpha\f$ (1/angstrom) [0.2]
+     * `ewald_kmax`   | Include k-vectors with \f$n_x^2+n_y^2+n_z^2\leq\f$ `kmax`\f$^2\f$ [5]
+     *
+     * @note Uniform neutralizing background and surface terms are not included.
+     * @author Martin Trulsson and Mikael Lund
+     * @date Lund, 2013
+     */
+    template<class Tpairpot, class Tgeometry=Geometry::Cuboid>
+      class NonbondedEwald : public Nonbonded<Tpairpot,Tgeometry> {
+        private:
+          typedef Nonbonded<Tpairpot,Tgeometry> Tbase;
+          typedef std::complex<double> Tcomplex;
+          typedef vector<Tcomplex> Tsfactor;
+          using Tbase::geometry;
+
+          Space* spcPtr;
+          double alpha, lB;
+          int kmax;
+          Point box;                    //!< Box length used for current k-vectors
+          vector<Eigen::Vector3i> nvec; //!< Integer k-vectors (half space)
+          vector<double> A;             //!< Pair prefactor for each k-vector (kT)
+          double Asum;                  //!< Sum of prefactors
+          Tsfactor Q;                   //!< Structure factor of Space::p
+          Tsfactor dQ;                  //!< Change in Q due to current trial move
+          Tsfactor Qtrial;              //!< Structure factor of Space::trial
+          Tsfactor s, tmp;              //!< Work arrays
+          vector<Tcomplex> ex, ey, ez;  //!< Work arrays for exp(i*k*r) in each direction
+          bool Qsync;                   //!< True if Q matches Space::p
+          bool Qtrialsync;              //!< True if Qtrial matches Space::trial
+          bool intrial;                 //!< True during trial move
+          bool dQvalid;                 //!< True if dQ describes the trial move
+          size_t Qsize;                 //!< Number of particles when Q was calculated
+
+          string _info() {
+            using namespace textio;
+            std::ostringstream o;
+            o << Tbase::_info()
+              << pad(SUB,25,"Ewald alpha") << alpha << _angstrom+superminus+"1" << endl
+              << pad(SUB,25,"Ewald kmax") << kmax << endl
+              << pad(SUB,25,"Number of k-vectors") << nvec.size() << endl;
+            return o.str();
+          }
+
+          /** @brief Generate k-vectors and prefactors if box has changed */
+          void updateKvectors() {
+            if (geometry.len==box && !nvec.empty())
+              return;
+            box=geometry.len;
+            double V=box.x()*box.y()*box.z();
+            Point twopiL( 2*pc::pi/box.x(), 2*pc::pi/box.y(), 2*pc::pi/box.z() );
+            nvec.clear();
+            A.clear();
+            for (int nx=0; nx<=kmax; nx++)
+              for (int ny=-kmax; ny<=kmax; ny++)
+                for (int nz=-kmax; nz<=kmax; nz++) {
+                  bool halfspace = (nx>0) || (nx==0 && ny>0) || (nx==0 && ny==0 && nz>0);
+                  if (halfspace && nx*nx+ny*ny+nz*nz<=kmax*kmax) {
+                    Point k( nx*twopiL.x(), ny*twopiL.y(), nz*twopiL.z() );
+                    double k2=k.squaredNorm();
+                    nvec.push_back( Eigen::Vector3i(nx,ny,nz) );
+                    A.push_back( 2 * 2*pc::pi/V * lB * exp(-k2/(4*alpha*alpha)) / k2 );
+                  }
+                }
+            Asum=std::accumulate(A.begin(), A.end(), 0.0);
+            Qsync=Qtrialsync=dQvalid=false;
+          }
+
+          /** @brief Add charge times exp(i*k*r) of a particle to `sum` */
+          void addParticle(const particle &a, Tsfactor &sum, double scale=1) {
+            if (std::abs(a.charge)<1e-12)
+              return;
+            Point phi( 2*pc::pi*a.x()/box.x(), 2*pc::pi*a.y()/box.y(), 2*pc::pi*a.z()/box.z() );
+            Tcomplex cx(cos(phi.x()),sin(phi.x())), cy(cos(phi.y()),sin(phi.y())), cz(cos(phi.z()),sin(phi.z()));
+            ex.resize(kmax+1);
+            ey.resize(2*kmax+1);
+            ez.resize(2*kmax+1);
+            ex[0]=ey[kmax]=ez[kmax]=Tcomplex(1,0);
+            for (int n=1; n<=kmax; n++) {
+              ex[n] = ex[n-1]*cx;
+              ey[kmax+n] = ey[kmax+n-1]*cy;
+              ez[kmax+n] = ez[kmax+n-1]*cz;
+              ey[kmax-n] = std::conj(ey[kmax+n]);
+              ez[kmax-n] = std::conj(ez[kmax+n]);
+            }
+            double q=scale*a.charge;
+            for (size_t k=0; k<nvec.size(); k++) {
+              auto &n=nvec[k];
+              sum[k] += q * ex[n.x()] * ey[kmax+n.y()] * ez[kmax+n.z()];
+            }
+          }
+
+          /** @brief Structure factor of single particle */
+          const Tsfactor& sfactor(const particle &a) {
+            s.assign(nvec.size(), Tcomplex(0,0));
+            addParticle(a,s);
+            return s;
+          }
+
+          /** @brief Structure factor of a range of particles */
+          template<class Trange>
+            void sfactor(const p_vec &p, const Trange &g, Tsfactor &sum) {
+              sum.assign(nvec.size(), Tcomplex(0,0));
+              for (auto i : g)
+                addParticle(p[i], sum);
+            }
+
+          /** @brief Structure factor of whole particle vector. Stored values are used for `Space` vectors */
+          const Tsfactor& sfactor(const p_vec &p) {
+            updateKvectors();
+            if (spcPtr!=nullptr) {
+              if (&p==&spcPtr->trial && !intrial)
+                return sfactor(spcPtr->p); // trial and p are identical outside moves
+              if (&p==&spcPtr->p) {
+                if (!Qsync || Qsize!=p.size()) {
+                  sfactor(p, Group(0,p.size()-1), Q);
+                  Qsize=p.size();
+                  Qsync=true;
+                }
+                return Q;
+              }
+              if (&p==&spcPtr->trial) {
+                if (!Qtrialsync) {
+                  if (dQvalid) {
+                    const Tsfactor &Qp=sfactor(spcPtr->p);
+                    Qtrial.resize(Qp.size());
+                    for (size_t k=0; k<Qp.size(); k++)
+                      Qtrial[k]=Qp[k]+dQ[k];
+                  } else
+                    sfactor(p, Group(0,p.size()-1), Qtrial);
+                  Qtrialsync=true;
+                }
+                return Qtrial;
+              }
+            }
+            sfactor(p, Group(0,p.size()-1), tmp);
+            return tmp;
+          }
+
+          /** @brief Sum_k A_k * 2 Re( a_k * conj(b_k) ) */
+          inline double cross(const Tsfactor &a, const Tsfactor &b) const {
+            double u=0;
+            for (size_t k=0; k<A.size(); k++)
+              u += A[k] * ( a[k].real()*b[k].real() + a[k].imag()*b[k].imag() );
+            return 2*u;
+          }
+
+          /** @brief Sum_k A_k * |a_k|^2 */
+          inline double norm(const Tsfactor &a) const {
+            double u=0;
+            for (size_t k=0; k<A.size(); k++)
+              u += A[k] * std::norm(a[k]);
+            return u;
+          }
+
+          /** @brief Reciprocal energy of particle i with the rest of the system */
+          double kspace_i2all(const p_vec &p, int i) {
+            const Tsfactor &Qall=sfactor(p);
+            const Tsfactor &si=sfactor(p[i]);
+            return cross(si,Qall) - 2*Asum*p[i].charge*p[i].charge;
+          }
+
+          /** @brief Reciprocal energy of group with the rest of the system */
+          double kspace_g2all(const p_vec &p, Group &g) {
+            const Tsfactor &Qall=sfactor(p);
+            Tsfactor Sg;
+            sfactor(p,g,Sg);
+            return cross(Sg,Qall) - 2*norm(Sg);
+          }
+
+          /** @brief Reciprocal energy within group */
+          double kspace_internal(const p_vec &p, Group &g) {
+            updateKvectors();
+            Tsfactor Sg;
+            sfactor(p,g,Sg);
+            double q2=0;
+            for (auto i : g)
+              q2+=p[i].charge*p[i].charge;
+            return norm(Sg) - Asum*q2;
+          }
+
+        public:
+          NonbondedEwald(InputMap &in) : Tbase(in), spcPtr(nullptr) {
+            static_assert( std::is_base_of<Geometry::Cuboid,Tgeometry>::value
+                && !std::is_same<Geometry::Cuboidslit,Tgeometry>::value,
+                "Ewald summation requires a three dimensional periodic Cuboid" );
+            alpha = in.get<double>("ewald_alpha", 0.2, "Ewald damping parameter (1/AA)");
+            kmax = in.get<int>("ewald_kmax", 5, "Ewald max. k-vector index");
+            lB = Potential::Coulomb(in).bjerrumLength();
+            Tbase::name+=" + Ewald reciprocal space";
+            box.setZero();
+            Asum=0;
+            Qsize=0;
+            Qsync=Qtrialsync=intrial=dQvalid=false;
+            updateKvectors();
+          }
+
+          /** @brief Specify simulation Space. Required for incremental updates. */
+          void setSpace(Space &spc) {
+            spcPtr=&spc;
+            update();
+          }
+
+          /** @brief Recalculate stored structure factors from `Space::p` */
+          void update() {
+            Qsync=Qtrialsync=dQvalid=false;
+            intrial=false;
+          }
+
+          void trialUpdate(const Space &spc, const Change &c) FOVERRIDE {
+            if (&spc!=spcPtr)
+              return;
+            intrial=true;
+            Qtrialsync=false;
+            dQvalid=false;
+            if (!c.all()) {
+              sfactor(spcPtr->p); // make sure Q is up-to-date
+              if (Qsize==spcPtr->trial.size()) {
+                dQ.assign(nvec.size(), Tcomplex(0,0));
+                for (auto i : c.index) {
+                  addParticle(spcPtr->trial[i], dQ);
+                  addParticle(spcPtr->p[i], dQ, -1);
+                }
+                dQvalid=true;
+              }
+            }
+          }
+
+          void acceptUpdate(const Change&) FOVERRIDE {
+            if (spcPtr==nullptr || !intrial)
+              return;
+            updateKvectors();
+            if (dQvalid && Qsync) {
+              for (size_t k=0; k<Q.size(); k++)
+                Q[k]+=dQ[k];
+            } else if (Qtrialsync) {
+              std::swap(Q,Qtrial);
+              Qsize=spcPtr->p.size();
+              Qsync=true;
+            } else
+              Qsync=false;
+            intrial=Qtrialsync=dQvalid=false;
+          }
+
+          void rejectUpdate(const Change&) FOVERRIDE {
+            if (spcPtr==nullptr || !intrial)
+              return;
+            if (!dQvalid)
+              Qsync=false; // unknown move - p may have been modified
+            intrial=Qtrialsync=dQvalid=false;
+          }
+
+          void setVolume(double vol) FOVERRIDE {
+            Tbase::setVolume(vol);
+            updateKvectors();
+          }
+
+          double p2p(const particle &a, const particle &b) FOVERRIDE {
+            updateKvectors();
+            Tsfactor sa=sfactor(a);
+            return Tbase::p2p(a,b) + cross(sa, sfactor(b));
+          }
+
+          double all2p(const p_vec &p, const particle &a) FOVERRIDE {
+            const Tsfactor &Qall=sfactor(p);
+            return Tbase::all2p(p,a) + cross(sfactor(a), Qall);
+          }
+
+          double all2all(const p_vec &p) FOVERRIDE {
+            const Tsfactor &Qall=sfactor(p);
+            double q2=0;
+            for (auto &i : p)
+              q2+=i.charge*i.charge;
+            return Tbase::all2all(p) + norm(Qall) - Asum*q2;
+          }
+
+          /** @brief Not available as the reciprocal energy is no sum of inverse powers */
+          bool all2all_powers(const p_vec&, std::map<int,double>&) FOVERRIDE { return false; }
+
+          double i2i(const p_vec &p, int i, int j) FOVERRIDE {
+            return p2p(p[i],p[j]);
+          }
+
+          double i2g(const p_vec &p, Group &g, int i) FOVERRIDE {
+            double u=Tbase::i2g(p,g,i);
+            if (!g.empty()) {
+              updateKvectors();
+              Tsfactor Sg;
+              sfactor(p,g,Sg);
+              u+=cross(sfactor(p[i]), Sg);
+              if (g.find(i))
+                u-=2*Asum*p[i].charge*p[i].charge;
+            }
+            return u;
+          }
+
+          double i2all(const p_vec &p, int i) FOVERRIDE {
+            assert(i>=0 && i<int(p.size()) && "index i outside particle vector");
+            return Tbase::i2all(p,i) + kspace_i2all(p,i);
+          }
+
+          double i2all_change(const p_vec &pnew, const p_vec &pold, int i) FOVERRIDE {
+            return Tbase::i2all_change(pnew,pold,i)
+              + kspace_i2all(pnew,i) - kspace_i2all(pold,i);
+          }
+
+          double g2g(const p_vec &p, Group &g1, Group &g2) FOVERRIDE {
+            double u=Tbase::g2g(p,g1,g2);
+            if (g1.empty() || g2.empty())
+              return u;
+            updateKvectors();
+            Tsfactor S1, S2;
+            sfactor(p,g1,S1);
+            sfactor(p,g2,S2);
+            if (g1.find(g2.front()) && g1.find(g2.back())) {         // g2 is a subgroup of g1
+              for (size_t k=0; k<S1.size(); k++)
+                S1[k]-=S2[k];
+            } else if (g2.find(g1.front()) && g2.find(g1.back())) {  // g1 is a subgroup of g2
+              for (size_t k=0; k<S2.size(); k++)
+                S2[k]-=S1[k];
+            }
+            return u + cross(S1,S2);
+          }
+
+          double g2all(const p_vec &p, Group &g) FOVERRIDE {
+            double u=Tbase::g2all(p,g);
+            if (!g.empty())
+              u+=kspace_g2all(p,g);
+            return u;
+          }
+
+          double g_internal(const p_vec &p, Group &g) FOVERRIDE {
+            double u=Tbase::g_internal(p,g);
+            if (!g.empty())
+              u+=kspace_internal(p,g);
+            return u;
+          }
+
+          /** @brief Real and reciprocal space self energies of all particles in `Space` */
+          double external() FOVERRIDE {
+            if (spcPtr==nullptr)
+              return 0;
+            updateKvectors();
+            double q2=0;
+            for (auto &i : spcPtr->p)
+              q2+=i.charge*i.charge;
+            return (Asum - lB*alpha/sqrt(pc::pi)) * q2;
+          }
+
+          double v2v(const p_vec &p1, const p_vec &p2) FOVERRIDE {
+            Tsfactor Q1=sfactor(p1);
+            return Tbase::v2v(p1,p2) + cross(Q1, sfactor(p2));
+          }
+
+          /** @brief Not available as only the real space field would be included */
+          void field(const p_vec&, std::vector<Point>&) FOVERRIDE {
+            throw std::runtime_error("Electric field is not implemented for Ewald summation");
+          }
+      };
+
+    /**
+     * @brief Smooth particle-mesh Ewald (SPME) summation
+     *
+     * Reciprocal space electrostatics where charges are spread onto a
+     * mesh using cardinal B-splines and the convolution with the Ewald kernel
+     * is done by 3D fast Fourier transforms (doi:10/fp7mq2), see `FFT3D`. As for
+     * `NonbondedEwald`, the real space part is added via `Tpairpot` which
+     * should include `Potential::CoulombEwald`. The mesh energy,
+     * \f$\frac{1}{2}\sum Q\theta Q\f$, is split into pair terms,
+     * returned by the usual pair functions (`i2all()`, `g2g()` etc.), and
+     * particle self terms, returned by `i_external()` and `g_external()`.
+     * The self terms include the real space self energy and a
+     * small, position dependent mesh contribution.
+     *
+     * The electric potential on the mesh, \f$\phi=\theta * Q\f$, is stored for `Space::p`.
+     * For moves reporting which particles were changed, only the
+     * stencils of these particles are re-spread and the potential at the
+     * stencil points is corrected directly from the changed mesh charges.
+     * Accepted changes are collected and the full mesh potential is only
+     * recalculated by FFT once the number of changed mesh points exceeds
+     * `spme_maxpending` (by default balancing the cost of corrections and FFT).
+     * Moves with unknown changes and volume moves use full FFT evaluations.
+     *
+     * The InputMap is scanned for the following keywords:
+     *
+     * Key               | Description
+     * :---------------- | :--------------------------------------------------------
+     * `ewald_alpha`     | Damping parameter, \f$\alpha\f$ (1/angstrom) [0.2]
+     * `spme_order`      | B-spline interpolation order (even number) [4]
+     * `spme_spacing`    | Max. mesh spacing (angstrom) [1]
+     * `spme_mesh`       | Mesh points in each dimension (overrides spacing) [0]
+     * `spme_maxpending` | Max. changed mesh points before FFT refresh [0=auto]
+     *
+     * Example:
+     *
+     *     typedef Potential::CombinedPairPotential<Potential::CoulombEwald,Potential::LennardJones> Tpairpot;
+     *     Energy::Hamiltonian pot;
+     *     auto nb = pot.create( Energy::NonbondedSPME<Tpairpot,Geometry::Cuboid>(in) );
+     *     Space spc( pot.getGeometry() );
+     *     nb->setSpace(spc);
+     *
+     * @date Lund, 2013
+     */
+    template<class Tpairpot, class Tgeometry=Geometry::Cuboid>
+      class NonbondedSPME : public Nonbonded<Tpairpot,Tgeometry> {
+        private:
+          typedef Nonbonded<Tpairpot,Tgeometry> Tbase;
+          typedef FFT3D::Tcomplex Tcomplex;
+          using Tbase::geometry;
+
+          /** @brief Mesh charges on a subset of mesh points */
+          struct Sparse {
+            vector<double> val;  //!< Dense mesh values
+            vector<char> used;   //!< Non-zero flag for each mesh point
+            vector<int> idx;     //!< Index of non-zero mesh points
+            void init(int M) {
+              val.assign(M,0);
+              used.assign(M,0);
+              idx.clear();
+            }
+            void clear() {
+              for (auto i : idx) {
+                val[i]=0;
+                used[i]=0;
+              }
+              idx.clear();
+            }
+            inline void add(int i, double q) {
+              if (!used[i]) {
+                used[i]=1;
+                idx.push_back(i);
+              }
+              val[i]+=q;
+            }
+          };
+
+          /** @brief B-spline stencil of a single particle */
+          struct Stencil {
+            vector<int> idx;    //!< Mesh index
+            vector<double> w;   //!< Charge times B-spline weight
+          };
+
+          enum Tview {P, TRIALDELTA, TRIALFULL, OTHER};
+
+          Space* spcPtr;
+          double alpha, lB, spacing;
+          int order, meshsize, M;
+          size_t maxpending;
+          Eigen::Vector3i K;            //!< Mesh points in each direction
+          Point box;                    //!< Box length used for current mesh
+          FFT3D fft;
+          vector<Tcomplex> work;
+          vector<double> G;             //!< Ewald kernel times B-spline moduli in Fourier space
+          vector<double> theta;         //!< Ewald kernel on mesh (real space)
+          vector<double> phi;           //!< Mesh potential of Space::p (at last refresh)
+          vector<double> phitrial;      //!< Mesh potential of Space::trial (unknown moves)
+          vector<double> phiother;      //!< Mesh potential of other particle vectors
+          Sparse pending;               //!< Accepted mesh charge changes since last refresh
+          Sparse delta;                 //!< Mesh charge change of current trial move
+          Sparse S1, S2;                //!< Work meshes for groups
+          bool phisync, phitrialsync, intrial, deltavalid;
+          size_t phisize;
+          unsigned long int cntrefresh, cntlocal;
+
+          string _info() {
+            using namespace textio;
+            char w=25;
+            std::ostringstream o;
+            o << Tbase::_info()
+              << pad(SUB,w,"Ewald alpha") << alpha << _angstrom+superminus+"1" << endl
+              << pad(SUB,w,"B-spline order") << order << endl
+              << pad(SUB,w,"Mesh") << K.x() << " x " << K.y() << " x " << K.z() << endl
+              << pad(SUB,w,"FFT") << FFT3D::backend() << endl
+              << pad(SUB,w,"Max. pending mesh points") << maxpending << endl
+              << pad(SUB,w,"Local updates") << cntlocal << endl
+              << pad(SUB,w,"FFT convolutions") << cntrefresh << endl;
+            return o.str();
+          }
+
+          inline int wrap(int i, int k) const {
+            i%=k;
+            return (i<0) ? i+k : i;
+          }
+
+          /** @brief Kernel between two mesh points */
+          inline double th(int a, int b) const {
+            int ax=a%K.x(), ay=(a/K.x())%K.y(), az=a/(K.x()*K.y());
+            int bx=b%K.x(), by=(b/K.x())%K.y(), bz=b/(K.x()*K.y());
+            return theta[ wrap(ax-bx,K.x()) + K.x()*( wrap(ay-by,K.y()) + K.y()*wrap(az-bz,K.z()) ) ];
+          }
+
+          /** @brief Cardinal B-spline values, `Mn[j]=M_order(w+j)` */
+          void bspline(double w, vector<double> &Mn) const {
+            Mn.assign(order,0);
+            Mn[0]=w;
+            Mn[1]=1-w;
+            for (int n=3; n<=order; n++)
+              for (int j=n-1; j>=0; j--) {
+                double a = (j<n-1) ? (w+j)*Mn[j] : 0;
+                double b = (j>0) ? (n-w-j)*Mn[j-1] : 0;
+                Mn[j]=(a+b)/(n-1);
+              }
+          }
+
+          /** @brief Spread charge of particle onto mesh */
+          void stencil(const particle &a, Stencil &s) const {
+            s.idx.clear();
+            s.w.clear();
+            if (std::abs(a.charge)<1e-12)
+              return;
+            int k0[3];
+            vector<double> Mn[3];
+            for (int d=0; d<3; d++) {
+              double u = K[d]*(a[d]/box[d]+0.5);
+              u -= K[d]*std::floor(u/K[d]);
+              k0[d] = int(std::floor(u));
+              bspline(u-k0[d], Mn[d]);
+            }
+            for (int jz=0; jz<order; jz++)
+              for (int jy=0; jy<order; jy++)
+                for (int jx=0; jx<order; jx++) {
+                  s.idx.push_back( wrap(k0[0]-jx,K.x()) + K.x()*( wrap(k0[1]-jy,K.y()) + K.y()*wrap(k0[2]-jz,K.z()) ) );
+                  s.w.push_back( a.charge*Mn[0][jx]*Mn[1][jy]*Mn[2][jz] );
+                }
+          }
+
+          /** @brief Set up mesh and Ewald kernel for current box */
+          void updateMesh() {
+            if (geometry.len==box && M>0)
+              return;
+            box=geometry.len;
+            if (M==0) { // mesh size is fixed upon first use
+              for (int d=0; d<3; d++)
+                K[d] = FFT3D::goodSize( (meshsize>0) ? meshsize : int(std::ceil(box[d]/spacing)) );
+              M=K.prod();
+              fft.resize(K.x(),K.y(),K.z());
+              pending.init(M);
+              delta.init(M);
+              S1.init(M);
+              S2.init(M);
+              if (maxpending==0) {
+                size_t n = (spcPtr==nullptr) ? M : spcPtr->p.size();
+                maxpending = std::sqrt( 2*(5*M*std::log2(double(M)) + n*pow(order,3)) );
+              }
+            }
+
+            // B-spline moduli
+            vector<double> Mn, bmod[3];
+            bspline(0,Mn); // Mn[k]=M(k)
+            for (int d=0; d<3; d++) {
+              bmod[d].resize(K[d]);
+              for (int m=0; m<K[d]; m++) {
+                Tcomplex sum(0,0);
+                for (int k=0; k<order-1; k++)
+                  sum += Mn[k+1] * std::polar(1.0, 2*pc::pi*m*k/K[d]);
+                bmod[d][m] = std::norm(sum);
+              }
+            }
+
+            double V=box.x()*box.y()*box.z();
+            G.resize(M);
+            work.resize(M);
+            for (int mz=0; mz<K.z(); mz++)
+              for (int my=0; my<K.y(); my++)
+                for (int mx=0; mx<K.x(); mx++) {
+                  int i=mx+K.x()*(my+K.y()*mz);
+                  Point m( (mx<=K.x()/2 ? mx : mx-K.x())/box.x(),
+                      (my<=K.y()/2 ? my : my-K.y())/box.y(),
+                      (mz<=K.z()/2 ? mz : mz-K.z())/box.z() );
+                  double m2=m.squaredNorm();
+                  G[i] = (i==0) ? 0 : exp(-pc::pi*pc::pi*m2/(alpha*alpha)) / (pc::pi*V*m2)
+                    / (bmod[0][mx]*bmod[1][my]*bmod[2][mz]);
+                  work[i]=G[i];
+                }
+            fft.backward(work);
+            theta.resize(M);
+            for (int i=0; i<M; i++)
+              theta[i]=work[i].real();
+            phisync=phitrialsync=deltavalid=false;
+            pending.clear();
+            delta.clear();
+          }
+
+          /** @brief Mesh potential of particle vector by FFT */
+          void potential(const p_vec &p, vector<double> &out) {
+            Stencil s;
+            work.assign(M, Tcomplex(0,0));
+            for (auto &a : p) {
+              stencil(a,s);
+              for (size_t k=0; k<s.idx.size(); k++)
+                work[s.idx[k]] += s.w[k];
             }
+            convolute(out);
+          }
+
+          /** @brief Convolute `work` with Ewald kernel */
+          void convolute(vector<double> &out) {
+            fft.forward(work);
+            for (int i=0; i<M; i++)
+              work[i]*=G[i];
+            fft.backward(work);
+            out.resize(M);
+            for (int i=0; i<M; i++)
+              out[i]=work[i].real();
+            cntrefresh++;
+          }
+
+          /** @brief Potential at mesh point `x` from sparse mesh charges */
+          inline double correction(const Sparse &S, int x) const {
+            double u=0;
+            for (auto y : S.idx)
+              u += th(x,y)*S.val[y];
+            return u;
           }
-        }
-      }
-      kvec.resize(totk);
-      eikr.resize(totk);
-      eikrold.resize(totk);
-      cout << "# Number of wavefunctions :" << totk << endl;
-    }
-
-  template<class T>
-    void Ewald<T>::setVolume(T vol) {
-      assert(vol>0);
-      boxlen=pow(vol,1/3.);
-      halfboxlen=boxlen/2;
-      kSpaceInit();
-      store();
-    }
-
-  /**
-   * @param qq particle-particle charge product
-   * @param r particle-particle distance
-   */
-  template<class T>
-    T Ewald<T>::rSpaceEnergy(T qq, T r) {
-      return  (r*r>rcut2 ? 0 :
-          qq*std::erfc(r*alphasqrt)/r );
-    }
-
-  template<class T>
-    Ewald<T>::Ewald(InputMap &in, std::string pfx) {
-      a1=0.254829592;
-      a2=-0.284496736;
-      a3=1.421413741;
-      a4=-1.453152027;
-      a5=1.061405429;
-      p1=0.3275911;
-
-      int size  = in(pfx+"size",0);
-      kmax      = in(pfx+"kmax",5);
-      alpha     = in(pfx+"alpha",0.001);
-      Ewapre    = in(pfx+"Ewapre",0.01);
-      lB        = in("bjerrum",7.12591);
-      boxlen    = in("cuboid_len",0);
-      rcut2     = in(pfx+"cutoff", boxlen/2);
-      rcut2 = pow(rcut2,2);
-      halfboxlen= boxlen/2;
-      alphasqrt=sqrt(alpha);
-      T pi=std::acos(-1.);
-      twopi = 2*pi;
-      pisqrt = sqrt(pi);
-      ksqmax=kmax*kmax+1;
-      eix.resize(size);
-      eiy.resize(size);
-      eiz.resize(size);
-      eixold.resize(size);
-      eiyold.resize(size);
-      eizold.resize(size);
-      for (int i=0; i<size; i++) {
-        eix[i].resize(kmax+1);
-        eiy[i].resize(2*kmax+1);
-        eiz[i].resize(2*kmax+1);
-        eixold[i].resize(kmax+1);
-        eiyold[i].resize(2*kmax+1);
-        eizold[i].resize(2*kmax+1);
-      }
-      kSpaceInit();
-    }
-
-  template<class T>
-    string Ewald<T>::info() {
-      std::ostringstream o;
-      o << "# kmax                    = " << kmax << endl
-        << "# Number of wavefunctions = " << totk << endl;
-      return o.str();
-    }
-
-  template<class T>
-    void Ewald<T>::calcAlpha(int size, T inewaldpression) {
-      ewaldpres=inewaldpression;
-      int i=0;
-      T incr=1e-3, A=10;
-
-      while( A > (1.+1e-10) || A < (1-1e-10)) {
-        A=sqrt(alpha) * ewaldpres / exp( -alpha*rcut2 );
-
-        if (A>1) {
-          while (A > 1.) {
-            alpha-= incr;
-            A = sqrt(alpha) * ewaldpres / exp(-alpha*rcut2);
-            i++;
-            assert(i<=10000);
-          }
-          assert(i<=10000);
-
-          if (A < (1.-1e-10)) {
-            alpha += 2*incr;
-            A = sqrt(alpha)*ewaldpres / exp(-alpha*rcut2);
-            incr = incr*0.1;
-          }  
-        } else {
-          while (A < 1.) {
-            alpha += incr;
-            A = sqrt(alpha)*ewaldpres / exp(-alpha*rcut2);
-            assert(i<=10000);
-          }
-          assert(i<=10000);
-
-          if (A < (1.-1e-10)) {
-            alpha += 2*incr;
-            A = sqrt(alpha)*ewaldpres / exp(-alpha*rcut2);
-            incr = incr*0.1;
-          }
-        }
-      }
-
-      assert(alpha>=0 && "Alpha negative!");
-
-      cout << "# New alpha fit = " << alpha << endl;
-      alphasqrt=sqrt(alpha);
-
-      kmax = 1. + alpha*halfboxlen*boxlen/twopi*2.;
-      //ksqmax = (1.+alpha*halfboxlen*boxlen/twopi*2.)*(1.+alpha*halfboxlen*boxlen/twopi*2.);
-      ksqmax = kmax*kmax;
-      cout << "# New kmax fit = " << kmax << endl;
-
-      for (int i=0; i<size; i++) {
-        eix[i].resize(kmax+1);
-        eiy[i].resize(2*kmax+1);
-        eiz[i].resize(2*kmax+1);
-        eixold[i].resize(kmax+1);
-        eiyold[i].resize(2*kmax+1);
-        eizold[i].resize(2*kmax+1);
-      }
-    }
-
-  template<class T>
-    template<class Tpvec>
-    T Ewald<T>::selfEwald(const Tpvec &p) {
-      T u=0;
-      for (auto &i : p)
-        u += i.charge * i.charge;
-      return -u*lB*alphasqrt/pisqrt;
-    }
-
-  template<class T>
-    template<class Tpvec>
-    void Ewald<T>::kSpaceUpdate(const Tpvec &p) {
-      int size=p.size();
-      T twopii=twopi/boxlen;
-
-      for (int i=0; i<size; i++) {
-        eix[i][0]=complex<T>(1,0);
-        eiy[i][kmax]=complex<T>(1,0);      //kmax = defines the '0'
-        eiz[i][kmax]=complex<T>(1,0);
-
-        eix[i][1] = complex<T>( cos( twopii*p[i].x() ), sin( twopii*p[i].x() ) );
-        eiy[i][kmax+1] = complex<T>( cos( twopii*p[i].y() ), sin( twopii*p[i].y() ) );
-        eiz[i][kmax+1] = complex<T>( cos( twopii*p[i].z() ), sin( twopii*p[i].z() ) );
-
-        eiy[i][kmax-1] = conj(eiy[i][kmax+1]);
-        eiz[i][kmax-1] = conj(eiz[i][kmax+1]);
-      }
-
-      for (int kk=2; kk<(kmax+1); kk++) {
-        for (int i=0; i<size; i++) {
-          eix[i][kk]=eix[i][kk-1]*eix[i][1];
-          eiy[i][kmax+kk]=eiy[i][kmax+kk-1]*eiy[i][kmax+1];
-          eiy[i][kmax-kk]=conj(eiy[i][kmax+kk]);
-          eiz[i][kmax+kk]=eiz[i][kmax+kk-1]*eiz[i][kmax+1];
-          eiz[i][kmax-kk]=conj(eiz[i][kmax+kk]);
-        }
-      }
-    }
-
-  template<class T>
-    template<class Tpvec>
-    void Ewald<T>::kSpaceUpdate(const Tpvec &p, int j) {
-      T twopii=twopi/boxlen;
-
-      eix[j][0]    = complex<T>(1,0);
-      eiy[j][kmax] = complex<T>(1,0);
-      eiz[j][kmax] = complex<T>(1,0);
-
-      eix[j][1]      = complex<T>( cos(twopii*p[j].x() ), sin(twopii*p[j].x()) );
-      eiy[j][kmax+1] = complex<T>( cos(twopii*p[j].y() ), sin(twopii*p[j].y()) );
-      eiz[j][kmax+1] = complex<T>( cos(twopii*p[j].z() ), sin(twopii*p[j].z()) );
-
-      eiy[j][kmax-1] = conj( eiy[j][kmax+1] ); //1+kmax = -1   2+kmax = -2 osv.
-      eiz[j][kmax-1] = conj( eiz[j][kmax+1] );
-
-      for (int kk=2; kk<(kmax+1); kk++) {
-        eix[j][kk]      = eix[j][kk-1] * eix[j][1];
-        eiy[j][kmax+kk] = eiy[j][kmax+kk-1] * eiy[j][kmax+1];
-        eiy[j][kmax-kk] = conj(eiy[j][kmax+kk]);
-        eiz[j][kmax+kk] = eiz[j][kmax+kk-1] * eiz[j][kmax+1];
-        eiz[j][kmax-kk] = conj( eiz[j][kmax+kk] );
-      }
-    }
-
-  template<class T>
-    template<class Tpvec>
-    T Ewald<T>::kSpaceEnergy(const Tpvec &p) {
-      complex<T> sum;
-      int ksq;
-      T u=0, fact;
-      totk=0;
-      for (int kx=0; kx<(kmax+1); kx++) {
-        if (kx==0)
-          fact=1.;
-        else
-          fact=2.;
-        for (int ky=0; ky<(2*kmax+1); ky++) {
-          for (int kz=0; kz<(2*kmax+1); kz++) {
-            ksq=kx*kx+(ky-kmax)*(ky-kmax)+(kz-kmax)*(kz-kmax);
-            if ( ksq < ksqmax && ksq!=0 ) {
-              sum = complex<T>(0,0);
-              for (int i=0; i<(int)p.size(); i++)
-                sum += p[i].charge * eix[i][kx]*eiy[i][ky]*eiz[i][kz];
-              eikr[totk] = sum;
-              u += fact*kvec[totk]*std::real( sum*conj(sum) );
-              totk+=1;
+
+          /** @brief Prepare mesh potential for particle vector */
+          Tview view(const p_vec &p) {
+            updateMesh();
+            if (spcPtr!=nullptr) {
+              if (&p==&spcPtr->p || (&p==&spcPtr->trial && !intrial)) {
+                if (!phisync || phisize!=spcPtr->p.size() || pending.idx.size()>maxpending) {
+                  potential(spcPtr->p, phi);
+                  pending.clear();
+                  phisize=spcPtr->p.size();
+                  phisync=true;
+                }
+                return P;
+              }
+              if (&p==&spcPtr->trial) {
+                if (deltavalid) {
+                  view(spcPtr->p);
+                  return TRIALDELTA;
+                }
+                if (!phitrialsync) {
+                  potential(p, phitrial);
+                  phitrialsync=true;
+                }
+                return TRIALFULL;
+              }
             }
+            potential(p, phiother);
+            return OTHER;
           }
-        }
-      }
-      return u*lB;
-    }
-
-  template<class T>
-    template<class Tpvec>
-    T Ewald<T>::kSpaceEnergy(const Tpvec &p, int j) {
-      complex<T> sum;
-      T u=0, fact;
-      totk=0;
-      for (int kx=0; kx<(kmax+1); kx++) {
-        (kx==0 ? fact=1 : fact=2);
-        for (int ky=0; ky<(2*kmax+1); ky++) {
-          for (int kz=0; kz<(2*kmax+1); kz++) {
-            int ksq=kx*kx+(ky-kmax)*(ky-kmax)+(kz-kmax)*(kz-kmax);
-            if (ksq < ksqmax && ksq!=0) {
-              eikr[totk] = eikrold[totk]+p[j].charge *
-                ( eix[j][kx]*eiy[j][ky]*eiz[j][kz]
-                  - eixold[j][kx]*eiyold[j][ky]*eizold[j][kz] );
-              sum = eikr[totk];
-              u += fact*kvec[totk] * std::real( sum*conj(sum) );
-              totk+=1;
+
+          /** @brief Mesh potential at point `x` */
+          double phiAt(Tview v, int x) const {
+            switch (v) {
+              case P:
+                return phi[x] + correction(pending,x);
+              case TRIALDELTA:
+                return phi[x] + correction(pending,x) + correction(delta,x);
+              case TRIALFULL:
+                return phitrial[x];
+              default:
+                return phiother[x];
             }
           }
-        }
-      }
-      return u*lB;
-    }
 
-}//namespace
+          /** @brief Stencil charges times mesh potential */
+          double energy(Tview v, const Stencil &s) const {
+            double u=0;
+            for (size_t k=0; k<s.idx.size(); k++)
+              u += s.w[k]*phiAt(v,s.idx[k]);
+            return u;
+          }
+
+          /** @brief sum Q1*theta*Q2 for two stencils */
+          double pair(const Stencil &a, const Stencil &b) const {
+            double u=0;
+            for (size_t i=0; i<a.idx.size(); i++)
+              for (size_t j=0; j<b.idx.size(); j++)
+                u += a.w[i]*th(a.idx[i],b.idx[j])*b.w[j];
+            return u;
+          }
+
+          /** @brief Spread particles in index range onto sparse mesh */
+          template<class Trange>
+            void spread(const p_vec &p, const Trange &g, Sparse &S) const {
+              Stencil s;
+              S.clear();
+              for (auto i : g) {
+                stencil(p[i],s);
+                for (size_t k=0; k<s.idx.size(); k++)
+                  S.add(s.idx[k], s.w[k]);
+              }
+            }
+
+          /** @brief sum Q1*theta*Q2 for two sparse meshes - direct or by FFT */
+          double quad(const Sparse &a, const Sparse &b) {
+            double u=0;
+            if ( double(a.idx.size())*b.idx.size() < 5*M*std::log2(double(M)) ) {
+              for (auto x : a.idx)
+                u += a.val[x]*correction(b,x);
+              return u;
+            }
+            work.assign(M, Tcomplex(0,0));
+            for (auto x : a.idx)
+              work[x]=a.val[x];
+            vector<double> phia;
+            convolute(phia);
+            for (auto y : b.idx)
+              u += phia[y]*b.val[y];
+            return u;
+          }
+
+          /** @brief Mesh energy within group, excluding self terms (without prefactor) */
+          double meshInternal(const p_vec &p, Group &g) {
+            if (g.empty())
+              return 0;
+            updateMesh();
+            spread(p,g,S1);
+            double self=0;
+            Stencil s;
+            for (auto i : g) {
+              stencil(p[i],s);
+              self+=meshself(s);
+            }
+            return 0.5*quad(S1,S1) - self;
+          }
+
+          /** @brief Position dependent mesh self energy (without prefactor) */
+          double meshself(const Stencil &s) const {
+            return 0.5*pair(s,s);
+          }
+
+        public:
+          NonbondedSPME(InputMap &in) : Tbase(in), spcPtr(nullptr) {
+            static_assert( std::is_base_of<Geometry::Cuboid,Tgeometry>::value
+                && !std::is_same<Geometry::Cuboidslit,Tgeometry>::value,
+                "Ewald summation requires a three dimensional periodic Cuboid" );
+            alpha = in.get<double>("ewald_alpha", 0.2, "Ewald damping parameter (1/AA)");
+            order = in.get<int>("spme_order", 4, "SPME B-spline order");
+            spacing = in.get<double>("spme_spacing", 1.0, "SPME max. mesh spacing (AA)");
+            meshsize = in.get<int>("spme_mesh", 0, "SPME mesh points per dimension");
+            maxpending = in.get<int>("spme_maxpending", 0, "SPME max. pending mesh points");
+            assert(order>=2 && order%2==0 && "B-spline order must be even");
+            lB = Potential::Coulomb(in).bjerrumLength();
+            Tbase::name+=" + SPME";
+            box.setZero();
+            K.setZero();
+            M=0;
+            phisize=0;
+            cntrefresh=cntlocal=0;
+            phisync=phitrialsync=intrial=deltavalid=false;
+          }
+
+          /** @brief Specify simulation Space. Required for local mesh updates. */
+          void setSpace(Space &spc) {
+            spcPtr=&spc;
+            update();
+          }
+
+          /** @brief Recalculate mesh potential from `Space::p` upon next use */
+          void update() {
+            phisync=phitrialsync=deltavalid=intrial=false;
+          }
+
+          void trialUpdate(const Space &spc, const Change &c) FOVERRIDE {
+            if (&spc!=spcPtr)
+              return;
+            updateMesh();
+            intrial=true;
+            phitrialsync=deltavalid=false;
+            delta.clear();
+            if (!c.all() && spc.p.size()==spc.trial.size()) {
+              Stencil s;
+              for (auto i : c.index) {
+                stencil(spc.trial[i],s);
+                for (size_t k=0; k<s.idx.size(); k++)
+                  delta.add(s.idx[k], s.w[k]);
+                stencil(spc.p[i],s);
+                for (size_t k=0; k<s.idx.size(); k++)
+                  delta.add(s.idx[k], -s.w[k]);
+              }
+              deltavalid=true;
+              cntlocal++;
+            }
+          }
+
+          void acceptUpdate(const Change&) FOVERRIDE {
+            if (spcPtr==nullptr || !intrial)
+              return;
+            updateMesh();
+            if (deltavalid && phisync) {
+              for (auto i : delta.idx)
+                pending.add(i, delta.val[i]);
+            } else if (phitrialsync) {
+              std::swap(phi, phitrial);
+              pending.clear();
+              phisize=spcPtr->p.size();
+              phisync=true;
+            } else
+              phisync=false;
+            delta.clear();
+            intrial=phitrialsync=deltavalid=false;
+          }
+
+          void rejectUpdate(const Change&) FOVERRIDE {
+            if (spcPtr==nullptr || !intrial)
+              return;
+            if (!deltavalid)
+              phisync=false; // unknown move - p may have been modified
+            delta.clear();
+            intrial=phitrialsync=deltavalid=false;
+          }
+
+          void setVolume(double vol) FOVERRIDE {
+            Tbase::setVolume(vol);
+            updateMesh();
+          }
+
+          /** @brief Self energy of particle (real space and mesh) */
+          double i_external(const p_vec &p, int i) FOVERRIDE {
+            updateMesh();
+            Stencil s;
+            stencil(p[i],s);
+            return lB*( meshself(s) - alpha/sqrt(pc::pi)*p[i].charge*p[i].charge );
+          }
+
+          double g_external(const p_vec &p, Group &g) FOVERRIDE {
+            double u=0;
+            for (auto i : g)
+              u+=i_external(p,i);
+            return u;
+          }
+
+          double p2p(const particle &a, const particle &b) FOVERRIDE {
+            updateMesh();
+            Stencil sa, sb;
+            stencil(a,sa);
+            stencil(b,sb);
+            return Tbase::p2p(a,b) + lB*pair(sa,sb);
+          }
+
+          double i2i(const p_vec &p, int i, int j) FOVERRIDE {
+            return p2p(p[i],p[j]);
+          }
+
+          double all2p(const p_vec &p, const particle &a) FOVERRIDE {
+            Tview v=view(p);
+            Stencil s;
+            stencil(a,s);
+            return Tbase::all2p(p,a) + lB*energy(v,s);
+          }
+
+          double i2all(const p_vec &p, int i) FOVERRIDE {
+            assert(i>=0 && i<int(p.size()) && "index i outside particle vector");
+            Tview v=view(p);
+            Stencil s;
+            stencil(p[i],s);
+            return Tbase::i2all(p,i) + lB*( energy(v,s) - 2*meshself(s) );
+          }
+
+          double i2all_change(const p_vec &pnew, const p_vec &pold, int i) FOVERRIDE {
+            Stencil s;
+            stencil(pnew[i],s);
+            double du = energy(view(pnew),s) - 2*meshself(s); // views may share a buffer:
+            stencil(pold[i],s);                               // finish one before the other
+            du -= energy(view(pold),s) - 2*meshself(s);
+            return Tbase::i2all_change(pnew,pold,i) + lB*du;
+          }
+
+          double i2g(const p_vec &p, Group &g, int i) FOVERRIDE {
+            double u=Tbase::i2g(p,g,i);
+            if (!g.empty()) {
+              updateMesh();
+              Stencil s;
+              stencil(p[i],s);
+              spread(p,g,S1);
+              for (size_t k=0; k<s.idx.size(); k++)
+                u += lB*s.w[k]*correction(S1,s.idx[k]);
+              if (g.find(i))
+                u -= lB*2*meshself(s);
+            }
+            return u;
+          }
+
+          double g2g(const p_vec &p, Group &g1, Group &g2) FOVERRIDE {
+            double u=Tbase::g2g(p,g1,g2);
+            if (g1.empty() || g2.empty())
+              return u;
+            updateMesh();
+            vector<int> a, b;
+            if (g1.find(g2.front()) && g1.find(g2.back())) {         // g2 is a subgroup of g1
+              for (auto i : g1)
+                if (!g2.find(i))
+                  a.push_back(i);
+              b.assign(g2.begin(), g2.end());
+            } else if (g2.find(g1.front()) && g2.find(g1.back())) {  // g1 is a subgroup of g2
+              for (auto i : g2)
+                if (!g1.find(i))
+                  a.push_back(i);
+              b.assign(g1.begin(), g1.end());
+            } else {
+              a.assign(g1.begin(), g1.end());
+              b.assign(g2.begin(), g2.end());
+            }
+            spread(p,a,S1);
+            spread(p,b,S2);
+            return u + lB*quad(S1,S2);
+          }
+
+          double g2all(const p_vec &p, Group &g) FOVERRIDE {
+            double u=Tbase::g2all(p,g);
+            if (g.empty())
+              return u;
+            Tview v=view(p);
+            spread(p,g,S1);
+            double uphi=0;
+            for (auto x : S1.idx)
+              uphi += S1.val[x]*phiAt(v,x);
+            return u + lB*( uphi - quad(S1,S1) );
+          }
+
+          double g_internal(const p_vec &p, Group &g) FOVERRIDE {
+            return Tbase::g_internal(p,g) + lB*meshInternal(p,g);
+          }
+
+          double all2all(const p_vec &p) FOVERRIDE {
+            Group g(0,p.size()-1);
+            return Tbase::all2all(p) + lB*meshInternal(p,g);
+          }
+
+          /** @brief Not available as the reciprocal energy is no sum of inverse powers */
+          bool all2all_powers(const p_vec&, std::map<int,double>&) FOVERRIDE { return false; }
+
+          double v2v(const p_vec &p1, const p_vec &p2) FOVERRIDE {
+            double u=Tbase::v2v(p1,p2);
+            updateMesh();
+            Group g1(0,p1.size()-1), g2(0,p2.size()-1);
+            spread(p1,g1,S1);
+            spread(p2,g2,S2);
+            return u + lB*quad(S1,S2);
+          }
+
+          /** @brief Not available as only the real space field would be included */
+          void field(const p_vec&, std::vector<Point>&) FOVERRIDE {
+            throw std::runtime_error("Electric field is not implemented for SPME summation");
+          }
+      };
+
+  }//namespace Energy
+}//namespace Faunus
 #endif
@@ -34,6 +34,7 @@
 #include <faunus/space.h>
 #include <faunus/move.h>
 #include <faunus/mcloop.h>
+#include <faunus/checkpoint.h>
 #include <faunus/group.h>
 #include <faunus/io.h>
 #include <faunus/drift.h>
@@ -0,0 +1,57 @@
+#ifndef FAU_FFT_H
+#define FAU_FFT_H
+
+#ifndef SWIG
+#include <faunus/common.h>
+#include <complex>
+#endif
+
+namespace Faunus {
+
+  /**
+   * @brief Three dimensional complex fast Fourier transform
+   *
+   * Data is stored in a flat vector with `x` running fastest, i.e. the
+   * element `(i,j,k)` is found at `i+nx*(j+ny*k)`. The transforms are
+   * unnormalized: `forward()` uses \f$e^{-i\ldots}\f$ and `backward()`
+   * \f$e^{+i\ldots}\f$ so that a forward followed by a backward transform
+   * scales the data by the number of elements.
+   *
+   * If Faunus is built with `ENABLE_FFTW`, FFTW3 is used for the transforms
+   * and any mesh size is supported. Otherwise a bundled radix-2
+   * algorithm is used and the dimensions must be powers of two - use
+   * `goodSize()` to find a suitable size.
+   *
+   *     FFT3D fft;
+   *     fft.resize(32,32,64);
+   *     std::vector<FFT3D::Tcomplex> data( fft.size() );
+   *     fft.forward(data);
+   *
+   * @date Lund, 2013
+   */
+  class FFT3D {
+    public:
+      typedef std::complex<double> Tcomplex;
+      typedef std::vector<Tcomplex> Tvec;
+    private:
+      int n[3];
+      Tvec buf;
+      void *plan[2];                                //!< FFTW plans (if used)
+      void *fftwbuf;                                //!< FFTW data buffer (if used)
+      void transform(Tvec&, int);                   //!< Bundled radix-2 transform
+      void cleanup();
+    public:
+      FFT3D();
+      FFT3D(const FFT3D&);
+      FFT3D& operator=(const FFT3D&);
+      ~FFT3D();
+      void resize(int, int, int);                   //!< Set mesh dimensions
+      int size() const;                             //!< Total number of mesh points
+      void forward(Tvec&);                          //!< Forward transform (in-place)
+      void backward(Tvec&);                         //!< Backward transform (in-place, unnormalized)
+      static int goodSize(int);                     //!< Smallest supported dimension larger than or equal to n
+      static std::string backend();                 //!< Name of FFT implementation
+  };
+
+}//namespace
+#endif
@@ -61,8 +61,9 @@ namespace Faunus {
         virtual void randompos(Point &)=0;              //!< Random point within container
         virtual void boundary(Point &) const=0;             //!< Apply boundary conditions to a point
         virtual void scale(Point&, const double&) const;    //!< Scale point to a new volume - for NPT ensemble
+        virtual bool isotropic() const { return false; }    //!< True if `scale()` scales all distances equally
         virtual double sqdist(const Point &a, const Point &b) const=0; //!< Squared distance between two points
-        virtual Point vdist(const Point&, const Point&)=0;  //!< Distance in vector form
+        virtual Point vdist(const Point&, const Point&) const=0;//!< Distance in vector form
         virtual ~Geometrybase();
     };
 
@@ -85,10 +86,22 @@ namespace Faunus {
         void randompos(Point &);
         void boundary(Point &p) const {};
         bool collision(const particle &, collisiontype=BOUNDARY) const;
+        bool isotropic() const { return true; }
         inline double sqdist(const Point &a, const Point &b) const {
           return (a-b).squaredNorm();
         }
-        inline Point vdist(const Point &a, const Point &b) { return a-b; }
+
+        /** @brief Squared distances from a point to `n` points stored as separate coordinate arrays */
+        inline void sqdist(const Point &a, const double *x, const double *y, const double *z,
+            double *r2, int n) const {
+          double ax=a.x(), ay=a.y(), az=a.z();
+          for (int j=0; j<n; j++) {
+            double dx=ax-x[j], dy=ay-y[j], dz=az-z[j];
+            r2[j] = dx*dx + dy*dy + dz*dz;
+          }
+        }
+
+        inline Point vdist(const Point &a, const Point &b) const { return a-b; }
         void scale(Point&, const double&) const; //!< Linear scaling along radius (NPT ensemble)
     };
 
@@ -118,6 +131,7 @@ namespace Faunus {
         void randompos(Point&);      
         bool save(string);           
         bool load(string,bool=false);
+        bool isotropic() const { return scaledir==XYZ; }
         inline bool collision(const particle &a, collisiontype type=BOUNDARY) const {
           if (std::abs(a.x())>len_half.x()) return true;
           if (std::abs(a.y())>len_half.y()) return true;
@@ -141,7 +155,32 @@ namespace Faunus {
           // return (d-k.cast<double>().cwiseProduct(len)).squaredNorm();
         }
 
-        inline Point vdist(const Point &a, const Point &b) {
+        /**
+         * @brief Squared distances from a point to `n` points stored as separate coordinate arrays
+         *
+         * The minimum image is found by rounding, `std::rint()`, so that the
+         * loop has no branches. GCC vectorizes it when SSE4.1 or later is
+         * available and the dynamic cost model is used, i.e. with `-O3` or
+         * with the `ENABLE_NATIVE` build option. Otherwise the loop runs as
+         * scalar code with the same result.
+         */
+        inline void sqdist(const Point &a, const double *x, const double *y, const double *z,
+            double *r2, int n) const {
+          double ax=a.x(), ay=a.y(), az=a.z();
+          double lx=len.x(), ly=len.y(), lz=len.z();
+          double ix=len_inv.x(), iy=len_inv.y(), iz=len_inv.z();
+          for (int j=0; j<n; j++) {
+            double dx=ax-x[j];
+            double dy=ay-y[j];
+            double dz=az-z[j];
+            dx -= lx*std::rint(dx*ix);
+            dy -= ly*std::rint(dy*iy);
+            dz -= lz*std::rint(dz*iz);
+            r2[j] = dx*dx + dy*dy + dz*dz;
+          }
+        }
+
+        inline Point vdist(const Point &a, const Point &b) const {
           Point r=a-b;
           if (r.x()>len_half.x())
             r.x()-=len.x();
@@ -185,7 +224,23 @@ namespace Faunus {
           return dx*dx + dy*dy + dz*dz;
         }   
 
-        inline Point vdist(const Point &a, const Point &b) {
+        /** @brief Squared distances from a point to `n` points stored as separate coordinate arrays */
+        inline void sqdist(const Point &a, const double *x, const double *y, const double *z,
+            double *r2, int n) const {
+          double ax=a.x(), ay=a.y(), az=a.z();
+          double lx=len.x(), ly=len.y();
+          double ix=len_inv.x(), iy=len_inv.y();
+          for (int j=0; j<n; j++) {
+            double dx=ax-x[j];
+            double dy=ay-y[j];
+            double dz=az-z[j];
+            dx -= lx*std::rint(dx*ix);
+            dy -= ly*std::rint(dy*iy);
+            r2[j] = dx*dx + dy*dy + dz*dz;
+          }
+        }
+
+        inline Point vdist(const Point &a, const Point &b) const {
           Point r(a-b);
           if (r.x()>len_half.x())
             r.x()-=len.x();
@@ -232,7 +287,18 @@ namespace Faunus {
         inline double sqdist(const Point &a, const Point &b) const {
           return (a-b).squaredNorm();
         }
-        inline Point vdist(const Point &a, const Point &b) { return a-b; }
+
+        /** @brief Squared distances from a point to `n` points stored as separate coordinate arrays */
+        inline void sqdist(const Point &a, const double *x, const double *y, const double *z,
+            double *r2, int n) const {
+          double ax=a.x(), ay=a.y(), az=a.z();
+          for (int j=0; j<n; j++) {
+            double dx=ax-x[j], dy=ay-y[j], dz=az-z[j];
+            r2[j] = dx*dx + dy*dy + dz*dz;
+          }
+        }
+
+        inline Point vdist(const Point &a, const Point &b) const { return a-b; }
     };
 
     /*!
@@ -253,7 +319,22 @@ namespace Faunus {
             dz-=len;
           return dx*dx + dy*dy + dz*dz;
         }
-        inline Point vdist(const Point &a, const Point &b) {
+
+        /** @brief Squared distances from a point to `n` points stored as separate coordinate arrays */
+        inline void sqdist(const Point &a, const double *x, const double *y, const double *z,
+            double *r2, int n) const {
+          double ax=a.x(), ay=a.y(), az=a.z();
+          double lz=len, iz=1/len;
+          for (int j=0; j<n; j++) {
+            double dx=ax-x[j];
+            double dy=ay-y[j];
+            double dz=az-z[j];
+            dz -= lz*std::rint(dz*iz);
+            r2[j] = dx*dx + dy*dy + dz*dz;
+          }
+        }
+
+        inline Point vdist(const Point &a, const Point &b) const {
           Point r=a-b;
           if (r.z()>halflen)
             r.z()-=len;
@@ -405,6 +486,136 @@ namespace Faunus {
         }
     };
 
+    /**
+     * @brief Linked-cell neighbour list for cuboid containers
+     *
+     * The container is divided into cells with sidelengths no smaller
+     * than a given cut-off distance so that all particles within the cut-off
+     * from a point are found in the surrounding 27 (or fewer) cells.
+     * Periodic boundaries are respected in all directions for `Cuboid`
+     * while `Cuboidslit` is treated as non-periodic in z.
+     * The list only stores particle indices and it is up to the user
+     * to keep it in sync with the particle vector - either by
+     * a full rebuild or by re-binning single particles that have moved.
+     *
+     * Example:
+     *
+     *     Geometry::CellList<Geometry::Cuboid> cells(12.0); // cut-off
+     *     cells.update(geo, spc.p);                         // full rebuild
+     *     for (auto c : cells.neighbours( cells.index(spc.p[0]) ))
+     *       for (auto j : cells[c])
+     *         ...                                            // do something with j
+     *     spc.p[10].x() += 1.0;
+     *     cells.update(spc.p, 10);                          // re-bin particle 10
+     *
+     * @date Lund, 2013
+     */
+    template<class Tgeometry=Cuboid>
+      class CellList {
+        private:
+          double rcut;                              //!< Cut-off distance
+          Point len, len_half;                      //!< Sidelengths of current layout
+          Eigen::Vector3i n;                        //!< Number of cells in each direction
+          bool periodicZ;                           //!< True if z is periodic
+          vector<vector<int> > cells;               //!< Particle index in each cell
+          vector<vector<int> > neighbourcells;      //!< Neighbouring cells of each cell (incl. self)
+          vector<int> cellindex;                    //!< Cell index of each particle
+
+          static bool isPeriodicZ(const Cuboid&) { return true; }
+          static bool isPeriodicZ(const Cuboidslit&) { return false; }
+
+          inline int bin(double x, int d) const {
+            int i=int( (x+len_half[d])/len[d]*n[d] );
+            return (i<0) ? 0 : ( (i>=n[d]) ? n[d]-1 : i );
+          }
+
+          /** @brief Set up cell layout and neighbour cells for given sidelengths */
+          void layout(const Point &l) {
+            len=l;
+            len_half=l*0.5;
+            for (int d=0; d<3; d++)
+              n[d] = (rcut>0) ? std::max(1, int(len[d]/rcut)) : 1;
+            cells.assign(n.prod(), vector<int>());
+            neighbourcells.resize(cells.size());
+            for (int ix=0; ix<n.x(); ix++)
+              for (int iy=0; iy<n.y(); iy++)
+                for (int iz=0; iz<n.z(); iz++) {
+                  auto &nb = neighbourcells[ ix+n.x()*(iy+n.y()*iz) ];
+                  nb.clear();
+                  for (int dx=-1; dx<=1; dx++)
+                    for (int dy=-1; dy<=1; dy++)
+                      for (int dz=-1; dz<=1; dz++) {
+                        int jz=iz+dz;
+                        if (!periodicZ && (jz<0 || jz>=n.z()))
+                          continue;
+                        int jx=(ix+dx+n.x()) % n.x();
+                        int jy=(iy+dy+n.y()) % n.y();
+                        jz=(jz+n.z()) % n.z();
+                        nb.push_back( jx+n.x()*(jy+n.y()*jz) );
+                      }
+                  std::sort(nb.begin(), nb.end()); // small boxes may have
+                  nb.erase( std::unique(nb.begin(), nb.end()), nb.end() ); // duplicate neighbours
+                }
+          }
+
+        public:
+          CellList(double cutoff=0) : rcut(cutoff), n(1,1,1), periodicZ(true) {
+            static_assert( std::is_base_of<Cuboid,Tgeometry>::value,
+                "Cell lists require a Cuboid geometry" );
+          }
+
+          void setCutoff(double cutoff) { rcut=cutoff; } //!< Set cut-off. Takes effect on next full update.
+
+          double getCutoff() const { return rcut; }      //!< Cut-off distance
+
+          /** @brief Cell index of a point */
+          inline int index(const Point &a) const {
+            return bin(a.x(),0) + n.x()*( bin(a.y(),1) + n.y()*bin(a.z(),2) );
+          }
+
+          /** @brief Index of cells neighbouring cell `c`, including `c` itself */
+          inline const vector<int>& neighbours(int c) const { return neighbourcells[c]; }
+
+          /** @brief Particle index in cell `c` */
+          inline const vector<int>& operator[](int c) const { return cells[c]; }
+
+          size_t size() const { return cellindex.size(); } //!< Number of binned particles
+
+          Eigen::Vector3i numCells() const { return n; }   //!< Number of cells in each direction
+
+          /** @brief True if layout matches geometry and particle vector size */
+          bool valid(const Tgeometry &geo, const p_vec &p) const {
+            return (p.size()==cellindex.size() && geo.len==len);
+          }
+
+          /** @brief Full rebuild of cell layout and particle binning */
+          void update(const Tgeometry &geo, const p_vec &p) {
+            periodicZ = isPeriodicZ(geo);
+            layout(geo.len);
+            cellindex.resize(p.size());
+            for (size_t i=0; i<p.size(); i++) {
+              cellindex[i] = index(p[i]);
+              cells[ cellindex[i] ].push_back(i);
+            }
+          }
+
+          /** @brief Re-bin a single particle that has been moved */
+          void update(const p_vec &p, int i) {
+            assert(i>=0 && i<(int)cellindex.size() && "Particle not in cell list");
+            int cnew = index(p[i]);
+            int cold = cellindex[i];
+            if (cnew!=cold) {
+              auto &c = cells[cold];
+              auto it = std::find(c.begin(), c.end(), i);
+              assert(it!=c.end() && "Particle not found in cell");
+              *it = c.back();
+              c.pop_back();
+              cells[cnew].push_back(i);
+              cellindex[i]=cnew;
+            }
+          }
+      };
+
   }//namespace Geometry
 }//namespace Faunus
 #endif
@@ -4,6 +4,10 @@
 #ifndef SWIG
 #include <faunus/common.h>
 #include <faunus/potentials.h>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 
 #ifndef __cplusplus
@@ -142,18 +146,48 @@ namespace Faunus {
    *  Saves simulation frames to a Gromacs xtc trajectory file including
    *  box information if applicable. Molecules with periodic boundaries
    *  can be saved as "whole" by adding their groups to the public g-vector.
+   *
+   *  Coordinate buffers are re-used between frames. If the constructor is given
+   *  a non-zero queue size, frames are compressed and written by a background
+   *  thread so that the simulation only waits for output if more than this number
+   *  of frames are pending. Pending frames are written when calling `close()`
+   *  or upon destruction.
+   *
+   *      FormatXTC xtc(1000, 4);  // queue up to four frames
+   *      xtc.save("traj.xtc", spc);
    */
   class FormatXTC {
     private:
-      p_vec p; //!< internal particle vector for temporary data
+      struct Frame {
+        std::vector<float> x;  //!< Coordinates in nm as consecutive xyz triplets
+        matrix box;
+        int step;
+        float time;
+      };
       XDRFILE *xd;        //!< file handle
       matrix xdbox;       //!< box dimensions
-      rvec *x_xtc;        //!< vector of particle coordinates
+      rvec *x_xtc;        //!< vector of particle coordinates (reading)
       float time_xtc, prec_xtc;
       int natoms_xtc, step_xtc;
+
+      unsigned int maxqueue;         //!< Max. number of pending frames (0=synchronous)
+      Frame buffer;                  //!< Frame buffer for synchronous output
+      std::deque<Frame> queue;       //!< Frames waiting to be written
+      std::deque<Frame> pool;        //!< Written frames available for re-use
+      std::thread writer;            //!< Background writer
+      std::mutex mtx;
+      std::condition_variable cv;
+      bool done;                     //!< Tell writer to finish
+
+      bool openWrite(string);        //!< Open file for writing and start writer
+      Frame getFrame(size_t);        //!< Empty frame for `n` particles
+      void putFrame(Frame&&);        //!< Write or queue frame
+      void write(Frame&);            //!< Write frame to disk
+      void writeLoop();              //!< Background writer loop
     public:
       std::vector<GroupMolecular*> g;          //!< List of PBC groups to be saved as whole
-      FormatXTC(float);                        //!< Constructor that sets an initially cubic box
+      FormatXTC(float, unsigned int=0);        //!< Constructor that sets an initially cubic box
+      ~FormatXTC();
       bool open(string);                       //!< Open xtc file for reading
       bool loadnextframe(Space&);              //!< Load a single frame into cuboid
       bool save(string, const p_vec&);         //!< Save a frame to trj file.
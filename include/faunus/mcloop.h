@@ -8,6 +8,7 @@
 
 namespace Faunus {
   class _inputfile;
+  class Checkpoint;
   /**
    * @brief Estimate speed of a computational process
    * 
@@ -60,6 +61,12 @@ namespace Faunus {
    * :---------------- | :-----------------------------
    * `loop_macrosteps` | Number of steps in outer loop
    * `loop_microsteps` | Number of steps in inner loop
+   * `loop_checkpoint` | Macrosteps between checkpoints (default: 0 = never)
+   *
+   * If a `Checkpoint` is given with `setCheckpoint()`, the loop counters are
+   * added to it and it is saved after every `loop_checkpoint` macrosteps.
+   * Restoring the checkpoint before entering the loop continues the
+   * simulation from the saved macrostep.
    *
    * Typical usage:
    *
@@ -85,6 +92,8 @@ namespace Faunus {
       unsigned int macro;          //!< Number of macrosteps
       unsigned int micro;          //!< Number of microsteps
       unsigned int cnt_micro, cnt_macro;
+      unsigned int ckinterval;     //!< Macrosteps between checkpoints
+      Checkpoint* ckpt;            //!< Checkpoint to save (nullptr if none)
       bool eq;
       string timing(unsigned int); //!< Show macrostep middle time and ETA (outdated!)
     public:
@@ -94,6 +103,9 @@ namespace Faunus {
       string timing();             //!< Show macrostep middle time and ETA.
       bool macroCnt();             //!< Increase and test macro loop counter
       bool microCnt();             //!< Increase and test micro loop counter
+      void setCheckpoint(Checkpoint&); //!< Save checkpoint at regular intervals
+      void save(std::ostream&);    //!< Write loop counters to binary stream
+      bool load(std::istream&);    //!< Read loop counters from binary stream
   };
 }
 #endif
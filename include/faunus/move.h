@@ -8,6 +8,7 @@
 #include <faunus/textio.h>
 #include <faunus/geometry.h>
 #include <faunus/energy.h>
+#include <ctime>
 
 #ifdef ENABLE_MPI
 #include <faunus/mpi.h>
@@ -114,7 +115,12 @@ namespace Faunus {
      * - `_info()`
      *
      * These functions should be pretty self-explanatory and are - via wrapper
-     * functions - called by move(). It is important that the _energyChange() function
+     * functions - called by move(). During `_trialMove()`, derived classes
+     * should record moved particles and groups, and volume or particle
+     * number changes, in `changed`. It is passed to the energy functions on trial,
+     * accept and reject so that stateful energy terms can update incrementally,
+     * and can be used with `Space::accept()` and `Space::undo()` to copy only
+     * changed particles. It is important that the _energyChange() function
      * returns the full energy associated with the move. For example, for NPT
      * moves the pV term should be included and so on. Try not to override
      * the move() function as this should be generic to all MC moves.
@@ -125,9 +131,12 @@ namespace Faunus {
     class Movebase {
       private:
         unsigned long int cnt_accepted;        //!< number of accepted moves
+        unsigned long int cnt_early;           //!< number of moves rejected due to infinite energy
         double dusum;                          //!< Sum of all energy changes made by this move
 
         virtual void _test(UnitTest&);         //!< Unit testing
+        virtual void _save(std::ostream&);     //!< Write state of derived move
+        virtual bool _load(std::istream&);     //!< Read state of derived move
         virtual string _info()=0;              //!< Specific info for derived moves
         virtual void _trialMove()=0;           //!< Do a trial move
         virtual void _acceptMove()=0;          //!< Accept move, store new coordinates.
@@ -148,6 +157,7 @@ namespace Faunus {
         string prefix;                   //!< inputmap prefix
         char w;                          //!< info string text width. Adjust this in constructor if needed.
         unsigned long int cnt;           //!< total number of trial moves
+        Change changed;                  //!< Changes made by current trial move - fill in `_trialMove()`
         virtual bool run() const;        //!< Runfraction test
 
         bool useAlternateReturnEnergy;   //!< Return a different energy than returned by _energyChange(). [false]
@@ -161,6 +171,8 @@ namespace Faunus {
         string info();                     //!< Returns information string
         void test(UnitTest&);              //!< Perform unit test
         double getAcceptance();            //!< Get acceptance [0:1]
+        void save(std::ostream&);          //!< Write state to binary stream (see `Checkpoint`)
+        bool load(std::istream&);          //!< Restore state from binary stream
     };
 
     /**
@@ -182,6 +194,8 @@ namespace Faunus {
         void _acceptMove();
         void _rejectMove();
         double _energyChange();
+        void _save(std::ostream&);
+        bool _load(std::istream&);
         bool run() const;                //!< Runfraction test
       protected:
         void _trialMove();
@@ -234,10 +248,16 @@ namespace Faunus {
      * tr.setGroup(g);              // specify which group to move
      * tr.move();                   // do the move
      * ~~~
+     *
+     * If the Hamiltonian has a group energy cache (`Energy::Hamiltonian::enableGroupCache()`),
+     * only the new group-group energies are calculated and the old ones
+     * are taken from the cache.
      */
     class TranslateRotate : public Movebase {
       protected:
         void _test(UnitTest&);
+        void _save(std::ostream&);
+        bool _load(std::istream&);
         void _trialMove();
         void _acceptMove();
         void _rejectMove();
@@ -403,6 +423,23 @@ namespace Faunus {
      * `reptation_runfraction` | Probability to perform a move (defaults=1)
      * `reptation_bondlength`  | The bond length while moving head groups. Use -1 to use existing bondlength.
      *
+     * If all monomers have identical properties (all particle fields but
+     * the position, including orientations) and identical bonds, the move
+     * is equivalent to taking the monomer at one end and placing it at the
+     * new position next to the other end. The energy change is then the
+     * energy of the new end monomer with all other particles, minus that of
+     * the leaving end monomer, and the cost is that of a single particle
+     * move. For non-uniform chains, the full chain energy is evaluated.
+     *
+     * Monomers are compared once per group, and bonds by placing a copy of
+     * the chain on a straight line at two spacings and comparing the pair
+     * energies of all nearest and next-nearest neighbours. Bonds to particles
+     * outside the chain are not detected and `setGroup()` must be called
+     * again if monomer properties (e.g. charges by titration) or bonds are
+     * changed. All monomers are shifted along the chain, so the trial
+     * configuration still marks the whole chain as changed and copying
+     * between `p` and `trial` scales with the chain length.
+     *
      * @date Lund 2012
      */
     class Reptation : public Movebase {
@@ -414,11 +451,91 @@ namespace Faunus {
         void _rejectMove();
         double _energyChange();
         string _info();
+        bool isUniform();       //!< Test if all monomers and bonds are identical
+        bool uniformBonds();    //!< Test if bonds along the chain are identical
         Group* gPtr;
         double bondlength; //!< Reptation length used when generating new head group position
+        int first;         //!< New end monomer in trial configuration
+        int leaving;       //!< End monomer in current configuration that leaves the chain
+        bool uniform;      //!< True if current chain has identical monomers
+        int uniformcheck;  //!< Cached result of isUniform() (-1 if not yet tested)
+        unsigned long cntuniform; //!< Number of single monomer energy evaluations
       public:
         Reptation(InputMap&, Energy::Energybase&, Space&, string="reptation");
         void setGroup(Group&); //!< Select Group to move
+        inline unsigned long uniformCount() const { return cntuniform; } //!< Number of single monomer energy evaluations
+    };
+
+    /**
+     * @brief Configurational-bias regrowth of linear polymers
+     *
+     * Between `minlen` and `maxlen` monomers at a random end of a linear chain
+     * are removed and regrown one at a time, starting from the remaining
+     * chain. For each monomer, `ntrial` positions are generated at the
+     * current bond length to its predecessor and one is picked with
+     * probability proportional to its Boltzmann factor. In a fraction
+     * `interior` of the moves, a single interior monomer is regrown instead
+     * and the trial positions are placed on the circle that keeps both bond
+     * lengths to its neighbours. The energy of each
+     * position is evaluated with the particles already in place, i.e.
+     * excluding monomers yet to be grown, via `Energy::Energybase::i2g()` and
+     * thus includes `Energy::Nonbonded` and `Energy::Bonded` as well as
+     * external potentials. The old configuration is retraced in the same
+     * way and the move is accepted with probability
+     * \f$\min(1,W_{new}/W_{old})\f$ where \f$W\f$ are the Rosenbluth weights,
+     * see doi:10.1080/00268979200100061.
+     *
+     * Energies are evaluated before the Hamiltonian is notified of the trial
+     * move and the energy classes should hence not rely on trial state, as
+     * is the case for cell lists and Ewald summation.
+     *
+     * Interior segments longer than one monomer would require closing the
+     * chain and are not supported. All trial positions of a monomer are
+     * generated first and then scored one at a time against the particles in
+     * place. With `Energy::NonbondedArrays` each score is a vectorized loop
+     * over all particles, which is longer than the few trial positions.
+     *
+     * Key            | Description
+     * :------------- | :--------------------------------------
+     * `cbmc_minlen`  | Minimum number of monomers to regrow (default: 1)
+     * `cbmc_maxlen`  | Maximum number of monomers to regrow (default: 4)
+     * `cbmc_ntrial`  | Number of trial positions per monomer (default: 10)
+     * `cbmc_interior`| Fraction of moves that regrow an interior monomer (default: 0)
+     * `cbmc_runfraction` | Probability to perform a move (default: 1)
+     *
+     * Besides the acceptance, `info()` reports the mean squared displacement
+     * per CPU second spent in the move which can be used to compare the
+     * efficiency with other polymer moves.
+     *
+     * @date Lund 2014
+     */
+    class Regrowth : public Movebase {
+      private:
+        void _test(UnitTest&);
+        void _trialMove();
+        void _acceptMove();
+        void _rejectMove();
+        double _energyChange();
+        string _info();
+        double grow(bool, double&);  //!< Grow or retrace monomers in `index`
+        Point trialPosition(int);    //!< Random trial position of monomer at current bond lengths
+        Group* gPtr;
+        vector<int> index;           //!< Monomers to regrow in order of growth
+        int dir;                     //!< Direction of growth: +1 at the back, -1 at the front end, 0 for an interior monomer
+        vector<double> u;            //!< Energies of trial positions
+        vector<Point> pos;           //!< Trial positions
+        double du;                   //!< \f$-\ln(W_{new}/W_{old})\f$ of current move
+        double cputime;              //!< CPU time spent in move (seconds)
+        double sqrsum;               //!< Sum of squared displacements
+        std::clock_t tstart;
+        AcceptanceMap<string> accmap;
+      public:
+        Regrowth(InputMap&, Energy::Energybase&, Space&, string="cbmc");
+        void setGroup(Group&); //!< Select Group of the polymer to regrow
+        int minlen;            //!< Minimum number of monomers to regrow
+        int maxlen;            //!< Maximum number of monomers to regrow
+        int ntrial;            //!< Number of trial positions per monomer
+        double interior;       //!< Fraction of moves that regrow a single interior monomer
     };
 
     /**
@@ -434,11 +551,22 @@ namespace Faunus {
      * :------------ | :-----------------------------
      * `npt_dV`      | Volume displacement parameter
      * `npt_P`       | Pressure [mM]
+     * `npt_powers`  | Predict pair energy from inverse power components (default: `no`)
+     * `npt_validate`| Check predicted energies against full evaluation (default: `no`)
      *
      * Note that new volumes are generated according to
      * \f$ V^{\prime} = \exp\left ( \log V \pm \delta dV \right ) \f$
      * where \f$\delta\f$ is a random number between zero and one half.
      *
+     * If all groups are atomic, the geometry scales all distances by the same
+     * factor \f$s\f$ and the Hamiltonian can be written as a sum of inverse
+     * powers, \f$U=\sum_n U_n\f$ with \f$U_n\propto r^{-n}\f$ (see
+     * `Energy::Energybase::all2all_powers()`), the pair energy of the trial
+     * volume is simply \f$\sum_n U_n s^{-n}\f$. With `npt_powers` enabled the
+     * components are calculated once and kept until particles are changed by
+     * other moves, reducing the cost of a volume move to that of the external
+     * energies. Otherwise, the full energy is evaluated.
+     *
      * Example:
      *
      *     Energy::Hamiltonian pot;        // we need a hamiltonian
@@ -458,7 +586,11 @@ namespace Faunus {
         void _acceptMove();
         void _rejectMove();
         double _energy(const p_vec&);
+        double _external(const p_vec&);
         double _energyChange();
+        bool predictable();
+        bool updatePowers();
+        double powerEnergy(double) const;
         double dV; //!< Volume displacement parameter
         double oldV;
         double newV;
@@ -466,6 +598,13 @@ namespace Faunus {
         Average<double> sqrV;       //!< Mean squared volume displacement
         Average<double> V;          //!< Average volume
         Average<double> rV;         //!< Average 1/volume
+        bool usepowers;             //!< Predict pair energy from inverse power components
+        bool validate;              //!< Compare predicted energy change with full evaluation
+        bool predicted;             //!< True if energy of current trial move was predicted
+        std::map<int,double> powers;//!< Pair energy components of `pcache`
+        p_vec pcache;               //!< Configuration for which `powers` is valid
+        unsigned long int cntpredict; //!< Number of predicted energy changes
+        double maxerr;              //!< Largest deviation from full evaluation
       public:
         Isobaric(InputMap&, Energy::Hamiltonian&, Space&, string="npt");
     };
@@ -478,6 +617,13 @@ namespace Faunus {
      * It contains functions to insert and erase particles while automatically moving particles
      * above the deletion or insertion point in sync.
      *
+     * A reverse table from particle index to position in the species list is kept
+     * so that only particles at or above the insertion or deletion point need
+     * to be updated. When erasing from an atomic group with `erase(index,group)` the
+     * last particle in the group fills the hole (see `Space::eraseSwap()`) and if the
+     * group is placed at the end of the particle vector, insertion at the end of the
+     * group and deletion are both constant time operations.
+     *
      * Example:
      *
      *     AtomTracker track(myspace);
@@ -488,20 +634,36 @@ namespace Faunus {
     class AtomTracker {
       public:
         typedef int Tindex; // particle index type
-      private:
-        Space* spc;
         class data {
-          public:
+          friend class AtomTracker;
+          private:
             vector<Tindex> index;
-            Tindex random();                  //!< Pick random particle index
+          public:
+            Tindex random() const;            //!< Pick random particle index
+            inline int size() const { return index.size(); } //!< Number of tracked particles
+            inline bool empty() const { return index.empty(); }
+            inline vector<Tindex>::const_iterator begin() const { return index.begin(); }
+            inline vector<Tindex>::const_iterator end() const { return index.end(); }
+        };
+      private:
+        struct slot {
+          data* d;  //!< Species list of particle (nullptr if not tracked)
+          int pos;  //!< Position in species list
         };
+        Space* spc;
         std::map<particle::Tid,data> map;
+        vector<slot> slots;                   //!< Reverse table - same size as `Space::p`
+        void track(Tindex);                   //!< Add particle to species list
+        void untrack(Tindex);                 //!< Remove particle from species list
+        void shift(Tindex);                   //!< Update species lists for particles at or above index
       public:
         AtomTracker(Space&);
         particle::Tid randomAtomType() const; //!< Select a random atomtype from the list
+        void add(Tindex);                     //!< Track particle already in Space
         bool insert(const particle&, Tindex); //!< Insert particle into Space and track position
         bool erase(Tindex);                   //!< Delete particle from Space at specific particle index
-        data& operator[] (particle::Tid);     //!< Access operator to atomtype data
+        bool erase(Tindex, Group&);           //!< Delete particle, filling the hole with last particle in atomic group
+        const data& operator[] (particle::Tid); //!< Access operator to atomtype data
         void clear();                         //!< Clear all atom lists (does not touch Space)
         bool empty();                         //!< Test if atom list is empty
     };
@@ -599,6 +761,89 @@ namespace Faunus {
 
 #endif
 
+    /**
+     * @brief Replica exchange with several replicas per process
+     *
+     * Each replica is a configuration (Space) with a Hamiltonian whose
+     * parameters are given by a *state* index. States, not coordinates, are
+     * exchanged: upon an accepted swap between states `k` and `k+1`, the
+     * two replicas simply change state via the `setState` function. For each
+     * exchange only the reduced energies of every replica in its current and
+     * neighbouring states are transmitted (four doubles per replica) and
+     * every process arrives at the same swaps using a shared random number
+     * stream. States `k,k+1` are attempted with alternating even/odd `k`.
+     *
+     * Replicas are added with `add()`, either in a single process or, if
+     * compiled with MPI, distributed over several ranks. States are numbered
+     * globally in rank order so that the `n`th replica added to the
+     * whole program starts in state `n`. The exchange can be split into
+     * `post()`, which calculates energies and starts a non-blocking
+     * collective, and `complete()`, which waits and applies the swaps.
+     * Work that does not alter the configurations, such as analysis and
+     * file output, can be done in between. Moving particles in between would
+     * bias the exchange acceptance.
+     *
+     *     Move::ReplicaExchange rex(mcp, &mpi);
+     *     rex.setState = [&](Energy::Energybase &e, int k) { ((myenergy&)e).Tscale=T[k]; };
+     *     rex.add(spc1, pot1);
+     *     rex.add(spc2, pot2);
+     *     ...
+     *     rex.exchange();
+     *
+     * The InputMap is scanned for the following keywords:
+     *
+     * Key              | Description
+     * :--------------- | :-------------------------------------------
+     * `replex_seed`    | Seed for exchange random numbers - must be identical on all ranks [0=no seeding]
+     *
+     * @date Lund 2013
+     */
+    class ReplicaExchange {
+      public:
+        struct replica {
+          Space* spc;
+          Energy::Energybase* pot;
+          int state;                    //!< Current state index
+          double u[3];                  //!< Reduced energy in states state-1, state, state+1 (kT)
+        };
+      private:
+        vector<replica> rep;            //!< Replicas in this process
+        vector<double> sendBuf, recvBuf;
+        vector<int> counts, displ;      //!< Number of doubles and offsets for each rank
+        vector<int> stateOf;            //!< Global state of each global replica
+        std::map<string, Average<double> > accmap;
+        unsigned long int cnt;
+        int first;                      //!< Global index of first local replica
+        int total;                      //!< Total number of replicas
+        bool inflight;
+        slump rng;                      //!< Random numbers shared by all processes
+#ifdef ENABLE_MPI
+        Faunus::MPI::MPIController *mpiPtr;
+        MPI_Request req;
+#endif
+        void setup();
+        double energy(replica&, int);   //!< Reduced energy of replica in given state
+      public:
+#ifdef ENABLE_MPI
+        ReplicaExchange(InputMap&, Faunus::MPI::MPIController* =nullptr, string="replex");
+#else
+        ReplicaExchange(InputMap&, string="replex");
+#endif
+        /** @brief Apply state parameters to Hamiltonian (required) */
+        std::function<void (Energy::Energybase&, int)> setState;
+
+        /** @brief Total system energy. Defaults to Energy::systemEnergy but can be replaced! */
+        std::function<double (Space&, Energy::Energybase&, const p_vec&)> usys;
+
+        void add(Space&, Energy::Energybase&);  //!< Add local replica - starts in next free state
+        int state(int) const;                   //!< State of i'th local replica
+        int size() const;                       //!< Number of local replicas
+        void post();                            //!< Calculate energies and start exchange
+        void complete();                        //!< Finish exchange and update states
+        void exchange();                        //!< Exchange states (post + complete)
+        string info();
+    };
+
     /** @brief Atomic translation with dipolar polarizability */
     typedef PolarizeMove<AtomicTranslation> AtomicTranslationPol;
 
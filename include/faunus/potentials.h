@@ -9,6 +9,7 @@
 #include <faunus/auxiliary.h>
 #include <faunus/inputfile.h>
 #include <faunus/species.h>
+#include <tuple>
 #endif
 
 using namespace Eigen;
@@ -217,6 +218,43 @@ namespace Faunus {
             return operator()(a,b,r.squaredNorm());
           }
 
+        /**
+         * @brief Add energies of `a` with `n` particles in a structure-of-arrays
+         * @param a Particle
+         * @param b Particle arrays (see `ParticleArrays`)
+         * @param first Index of first particle in `b`
+         * @param n Number of particles
+         * @param r2 Squared distances to the `n` particles
+         * @param u Energies are added to this array
+         */
+        template<class Tparticle, class Tarrays>
+          void batch(const Tparticle &a, const Tarrays &b, int first, int n,
+              const double *r2, double *u) const {
+            const double *radius = &b.radius[first];
+            for (int j=0; j<n; j++) {
+              double s=a.radius+radius[j];
+              double x=s*s/r2[j];
+              x=x*x*x;
+              u[j] += eps*(x*x - x);
+            }
+          }
+
+        /**
+         * @brief Add energy components proportional to inverse powers of distance
+         *
+         * The energy is split into `npowers()` terms, each proportional to
+         * \f$ r^{-n} \f$ with \f$n\f$ given by `power()`, and added to `u`.
+         * See `has_powers`.
+         */
+        template<class Tparticle>
+          void powers(const Tparticle &a, const Tparticle &b, double r2, double *u) const {
+            double x(r6(a.radius+b.radius,r2));
+            u[0] += eps*x*x;
+            u[1] -= eps*x;
+          }
+        static int npowers() { return 2; }                 //!< Number of energy components
+        static int power(int k) { return (k==0) ? 12 : 6; } //!< Inverse power of k'th component
+
         string info(char);
     };
 
@@ -536,6 +574,24 @@ namespace Faunus {
 #endif
         }
 
+      /** @brief Add energies of `a` with `n` particles in a structure-of-arrays (see `LennardJones::batch`) */
+      template<class Tparticle, class Tarrays>
+        void batch(const Tparticle &a, const Tarrays &b, int first, int n,
+            const double *r2, double *u) const {
+          const double *q = &b.charge[first];
+          double c = lB*a.charge;
+          for (int j=0; j<n; j++)
+            u[j] += c*q[j] / sqrt(r2[j]);
+        }
+
+      /** @brief Add energy proportional to \f$ r^{-1} \f$ (see `LennardJones::powers`) */
+      template<class Tparticle>
+        void powers(const Tparticle &a, const Tparticle &b, double r2, double *u) const {
+          u[0] += lB*a.charge*b.charge / sqrt(r2);
+        }
+      static int npowers() { return 1; }
+      static int power(int) { return 1; }
+
       template<class T>
         Point force(const T &a, const T &b, double r2, const Point &p) {
 #ifdef FAU_APPROXMATH
@@ -581,6 +637,37 @@ namespace Faunus {
         string info(char);
     };
 
+    /**
+     * @brief Real-space part of the Ewald summation
+     * @details The pair potential has the form
+     * @f[
+     * \beta u_{ij} = \frac{e^2}{4\pi\epsilon_0\epsilon_rk_BT}
+     * z_i z_j \frac{\mbox{erfc}(\alpha r)}{r}
+     * @f]
+     * and is zero beyond the cut-off, \f$R_c\f$. The reciprocal
+     * space part is handled by `Energy::NonbondedEwald`.
+     * The InputMap is scanned for
+     *
+     * - The parameters from `Potential::Coulomb`
+     * - `ewald_alpha` Damping parameter (1/angstrom)
+     * - `ewald_cutoff` Real space cut-off (angstrom)
+     */
+    class CoulombEwald : public Coulomb {
+      private:
+        double alpha, Rc2;
+      public:
+        CoulombEwald(InputMap&); //!< Construction from InputMap
+
+        template<class Tparticle>
+          double operator() (const Tparticle &a, const Tparticle &b, double r2) const {
+            if (r2>Rc2)
+              return 0;
+            double r=sqrt(r2);
+            return lB * a.charge * b.charge * std::erfc(alpha*r) / r;
+          }
+        string info(char);
+    };
+
     /**
      * @brief Charge-nonpolar pair interaction
      * @details This accounts for polarization of
@@ -645,6 +732,18 @@ namespace Faunus {
             return lB * a.charge * b.charge / r * exp(-k*r);
 #endif
           }
+
+        /** @brief Add energies of `a` with `n` particles in a structure-of-arrays (see `LennardJones::batch`) */
+        template<class Tparticle, class Tarrays>
+          void batch(const Tparticle &a, const Tarrays &b, int first, int n,
+              const double *r2, double *u) const {
+            const double *q = &b.charge[first];
+            double c = lB*a.charge;
+            for (int j=0; j<n; j++) {
+              double r=sqrt(r2[j]);
+              u[j] += c*q[j] / r * exp(-k*r);
+            }
+          }
         double entropy(double, double) const;         //!< Returns the interaction entropy 
         double ionicStrength() const;                 //!< Returns the ionic strength (mol/l)
         double debyeLength() const;                   //!< Returns the Debye screening length (angstrom)
@@ -724,6 +823,96 @@ namespace Faunus {
           }
       };
 
+    /**
+     * @brief Custom potentials between specific particle types using a dense type matrix
+     *
+     * Same as `PotentialMap` but all potential types that may be added
+     * must be given as template parameters. Potentials are stored by
+     * value and each `(id1,id2)` pair is resolved into an
+     * `ntypes x ntypes` matrix of small (type,index) cells, such that
+     * evaluation involves neither map lookups nor `std::function`
+     * calls. Pairs not added use `Tdefault`.
+     *
+     * Example:
+     *
+     *     typedef CombinedPairPotential<WeeksChandlerAndersen,CosAttract> Ttail;
+     *     PotentialMatrix<DebyeHuckelLJ, Ttail, ChargeNonpolar> pot(in);
+     *     pot.add( atom["TL"].id, atom["TL"].id, Ttail(in) );
+     *     pot.add( atom["Na"].id, atom["TL"].id, ChargeNonpolar(in) );
+     */
+    template<typename Tdefault, typename... Ts>
+      class PotentialMatrix : public Tdefault {
+        private:
+          struct cell {
+            unsigned char k;    //!< 0=default, otherwise index+1 in Ts
+            unsigned short i;   //!< Index in storage for type k
+          };
+          std::tuple<vector<Ts>...> pots; //!< Added potentials, sorted by type
+          vector<cell> mat;               //!< Dense type matrix
+          int ntypes;
+          std::string _info;
+
+          /* Position of T in Ts */
+          template<class T, int K, class... Tn> struct index;
+          template<class T, int K, class... Tn> struct index<T,K,T,Tn...> : std::integral_constant<int,K> {};
+          template<class T, int K, class U, class... Tn> struct index<T,K,U,Tn...> : index<T,K+1,Tn...> {};
+
+          template<int K, class Tparticle>
+            inline typename std::enable_if<(K<sizeof...(Ts)),double>::type
+            call(const cell &c, const Tparticle &a, const Tparticle &b, double r2) {
+              if (c.k==K+1)
+                return std::get<K>(pots)[c.i](a,b,r2);
+              return call<K+1>(c,a,b,r2);
+            }
+
+          template<int K, class Tparticle>
+            inline typename std::enable_if<(K>=sizeof...(Ts)),double>::type
+            call(const cell&, const Tparticle &a, const Tparticle &b, double r2) {
+              return Tdefault::operator()(a,b,r2);
+            }
+
+          void resize(int n) {
+            if (n<=ntypes)
+              return;
+            vector<cell> m(n*n, cell{0,0});
+            for (int i=0; i<ntypes; i++)
+              for (int j=0; j<ntypes; j++)
+                m[i*n+j]=mat[i*ntypes+j];
+            mat.swap(m);
+            ntypes=n;
+          }
+
+        public:
+          PotentialMatrix(InputMap &in) : Tdefault(in), ntypes(0) {
+            static_assert(sizeof...(Ts)<255, "Too many potential types");
+            Tdefault::name += " (default)";
+            resize( atom.list.size() );
+          }
+
+          /** @brief Set potential for pair of atom types. `Tpairpot` must be in `Ts`. */
+          template<class Tpairpot>
+            void add(AtomData::Tid id1, AtomData::Tid id2, Tpairpot pot) {
+              const int k=index<Tpairpot,0,Ts...>::value;
+              pot.name=atom[id1].name + "<->" + atom[id2].name + ": " + pot.name;
+              _info+="\n  " + pot.name + ":\n" + pot.info(20);
+              auto &v=std::get<k>(pots);
+              v.push_back(pot);
+              resize( std::max( int(atom.list.size()), std::max(id1,id2)+1 ) );
+              cell c = {(unsigned char)(k+1), (unsigned short)(v.size()-1)};
+              mat[id1*ntypes+id2]=mat[id2*ntypes+id1]=c;
+            }
+
+          template<class Tparticle>
+            double operator()(const Tparticle &a, const Tparticle &b, double r2) {
+              assert(a.id<ntypes && b.id<ntypes && "Atom type outside potential matrix");
+              return call<0>(mat[a.id*ntypes+b.id],a,b,r2);
+            }
+
+          std::string info(char w=20) {
+            return Tdefault::info(w) + _info;
+          }
+      };
+
     /**
      * @brief Combines two pair potentials
      * @details This combines two PairPotentialBases. The combined potential
@@ -767,6 +956,25 @@ namespace Faunus {
               return first(a,b,r2) + second(a,b,r2);
             }
 
+          /** @brief Batch energies - available if both potentials have `batch()` */
+          template<class Tparticle, class Tarrays>
+            void batch(const Tparticle &a, const Tarrays &b, int first_, int n,
+                const double *r2, double *u) const {
+              first.batch(a,b,first_,n,r2,u);
+              second.batch(a,b,first_,n,r2,u);
+            }
+
+          /** @brief Energy components - available if both potentials have `powers()` */
+          template<class Tparticle>
+            void powers(const Tparticle &a, const Tparticle &b, double r2, double *u) const {
+              first.powers(a,b,r2,u);
+              second.powers(a,b,r2,u+T1::npowers());
+            }
+          static int npowers() { return T1::npowers() + T2::npowers(); }
+          static int power(int k) {
+            return (k<T1::npowers()) ? T1::power(k) : T2::power(k-T1::npowers());
+          }
+
           template<typename Tparticle>
             Point field(const Tparticle &a, const Point &r) const {
               return first.field(a,r) + second.field(a,r);
@@ -796,6 +1004,35 @@ namespace Faunus {
           return *(new Potential::CombinedPairPotential<T1,T2>(pot1,pot2));
         }
 
+    /**
+     * @brief True if pair potential has a `batch()` function for structure-of-arrays evaluation
+     *
+     * This is specialized for each potential and is *not* inherited as derived
+     * potentials typically modify the energy function. `batch()` is therefore
+     * only used for the exact types listed here.
+     */
+    template<class T> struct has_batch : std::false_type {};
+    template<> struct has_batch<Coulomb> : std::true_type {};
+    template<> struct has_batch<DebyeHuckel> : std::true_type {};
+    template<> struct has_batch<LennardJones> : std::true_type {};
+    template<class T1, class T2> struct has_batch<CombinedPairPotential<T1,T2> >
+      : std::integral_constant<bool, has_batch<T1>::value && has_batch<T2>::value> {};
+
+    /**
+     * @brief True for pair potentials that are sums of inverse powers of distance
+     *
+     * Such potentials provide `powers()` which splits the energy into terms
+     * \f$u_n\propto r^{-n}\f$. When all distances are scaled by a factor
+     * \f$s\f$, each term scales as \f$s^{-n}\f$ which is used for
+     * volume moves, see `Move::Isobaric`. As for `has_batch` only the exact
+     * types listed here qualify.
+     */
+    template<class T> struct has_powers : std::false_type {};
+    template<> struct has_powers<Coulomb> : std::true_type {};
+    template<> struct has_powers<LennardJones> : std::true_type {};
+    template<class T1, class T2> struct has_powers<CombinedPairPotential<T1,T2> >
+      : std::integral_constant<bool, has_powers<T1>::value && has_powers<T2>::value> {};
+
     class MultipoleEnergy {
       public:
         double lB;
@@ -128,15 +128,35 @@ namespace Faunus {
     //http://www.lsinstruments.ch/technology/static_light_scattering_sls/structure_factor/
     /**
      * @brief Calculates scattering intensity, I(q) using the Debye formula
+     *
+     * Rather than evaluating the Debye formula for every pair and every q,
+     * pair distances are first binned in a histogram for each pair of particle
+     * types. The Debye formula is then applied to the histogram bins using form
+     * factors evaluated once per type and q. The cost is thus proportional to
+     * \f$ N^2 + N_{bins}N_q \f$ instead of \f$ N^2N_q \f$. With OpenMP the
+     * histogram is built in parallel using thread-local bins.
+     *
+     * Particles of the same type (id) are assumed to have identical form factors
+     * and distances are represented by the bin centers. The error from this is small
+     * as long as `qmax*dr` is much smaller than unity.
+     *
+     * Key          | Description
+     * :----------- | :-----------------------------------------
+     * `debye_dr`   | Distance resolution of pair histogram (default: 0.1 angstrom)
      */
     template<typename Tgeometry, typename Tformfactor> class DebyeFormula {
       private:
         Tformfactor F; // scattering from a single particle
         Tgeometry geo; // geometry to use for distance calculations
+        double dr;     // histogram resolution
+        typedef vector<vector<double> > Thist; // distance histogram for each type pair
       public:
         std::map<float,Average<float> > I; //!< Sampled, average I(q)
 
-        DebyeFormula(InputMap &in) : geo(in) {}
+        DebyeFormula(InputMap &in) : geo(in) {
+          dr = in.get<double>("debye_dr", 0.1, "Debye pair histogram resolution (A)");
+          assert(dr>0);
+        }
 
         /*!
          * \brief Sample I(q) and add to average
@@ -147,22 +167,77 @@ namespace Faunus {
          */
         void sample(const p_vec &p, float qmin, float qmax, float dq) {
           if (qmin<1e-6) qmin=dq;  // assure q>0
-          std::map<float,float> _I;
           int n=(int)p.size();
-#pragma omp parallel for reduction (+:I) schedule (dynamic)
-          for (int i=0; i<n-1; i++) {
-            for (int j=i+1; j<n; j++) {
-              float r = geo.dist(p[i],p[j]);
-              for (float q=qmin; q<=qmax; q+=dq) {
-                float _iq = F(q,p[i]) * F(q,p[j]) * sin(q*r) / (q*r);
-#pragma omp critical
-                _I[q] += _iq;
+
+          // particle types and a representative particle of each
+          std::map<particle::Tid,int> tmap;
+          vector<int> type(n);
+          vector<int> first;
+          for (int i=0; i<n; i++) {
+            auto it=tmap.find(p[i].id);
+            if (it==tmap.end()) {
+              it=tmap.insert( {p[i].id, (int)first.size()} ).first;
+              first.push_back(i);
+            }
+            type[i]=it->second;
+          }
+          int nt=first.size();
+
+          // pair distance histogram
+          Thist H(nt*nt);
+#pragma omp parallel
+          {
+            Thist h(nt*nt);
+#pragma omp for schedule (dynamic)
+            for (int i=0; i<n-1; i++)
+              for (int j=i+1; j<n; j++) {
+                size_t k = size_t( geo.dist(p[i],p[j]) / dr );
+                auto &hab = h[ std::min(type[i],type[j])*nt + std::max(type[i],type[j]) ];
+                if (k>=hab.size())
+                  hab.resize(k+1, 0);
+                hab[k]++;
               }
+#pragma omp critical
+            for (size_t ab=0; ab<h.size(); ab++) {
+              if (h[ab].size()>H[ab].size())
+                H[ab].resize(h[ab].size(), 0);
+              for (size_t k=0; k<h[ab].size(); k++)
+                H[ab][k]+=h[ab][k];
             }
           }
+
+          // form factors for each type and q
+          vector<float> qvec;
+          for (float q=qmin; q<=qmax; q+=dq)
+            qvec.push_back(q);
+          int nq=qvec.size();
+          vector<vector<float> > Fq(nt, vector<float>(nq));
+          for (int a=0; a<nt; a++)
+            for (int m=0; m<nq; m++)
+              Fq[a][m] = F(qvec[m], p[ first[a] ]);
+
+          // Debye formula applied to histogram
+          vector<double> _I(nq,0);
+#pragma omp parallel for schedule (dynamic)
+          for (int m=0; m<nq; m++) {
+            double q=qvec[m], sum=0;
+            for (int a=0; a<nt; a++)
+              for (int b=a; b<nt; b++) {
+                auto &hab = H[a*nt+b];
+                double s=0;
+                for (size_t k=0; k<hab.size(); k++)
+                  if (hab[k]>0) {
+                    double qr = q*(k+0.5)*dr;
+                    s += hab[k] * sin(qr) / qr;
+                  }
+                sum += Fq[a][m] * Fq[b][m] * s;
+              }
+            _I[m]=sum;
+          }
+
           float rho = n/geo.getVolume();
-          for (auto &i : _I)
-            I[i.first]+=2*rho*i.second; // add to average I(q)
+          for (int m=0; m<nq; m++)
+            I[ qvec[m] ] += 2*rho*_I[m]; // add to average I(q)
         }
 
         void save(string filename) {
@@ -2,7 +2,10 @@
 #define FAU_slump_h
 
 #include <string>
+#include <sstream>
 #include <random>
+#include <vector>
+#include <cstdint>
 #include <cassert>
 
 namespace Faunus {
@@ -19,6 +22,8 @@ namespace Faunus {
       std::string name;
       virtual ~RandomBase();
       virtual void seed(int=0)=0;   //!< Seed random generator
+      virtual void save(std::ostream&);  //!< Write generator state to binary stream
+      virtual bool load(std::istream&);  //!< Restore generator state from binary stream
       double randHalf();            //!< Random number in range `[-0.5:0.5[`
       unsigned int rand();          //!< Random number in range `[0:max unsigned int[`
       /*!
@@ -54,6 +59,8 @@ namespace Faunus {
     public:
       RandomRan2();
       void seed(int=-7);
+      void save(std::ostream&);
+      bool load(std::istream&);
   };
 
   /**
@@ -85,12 +92,83 @@ namespace Faunus {
 #pragma omp critical
           eng.seed(s);
         }
+        void save(std::ostream &o) {
+          std::ostringstream s;
+          s << eng;
+          std::string str=s.str();
+          uint64_t n=str.size();
+          o.write((const char*)&n, sizeof(n));
+          o.write(str.data(), n);
+        }
+        bool load(std::istream &in) {
+          uint64_t n=0;
+          in.read((char*)&n, sizeof(n));
+          std::string str(n,' ');
+          in.read(&str[0], n);
+          std::istringstream s(str);
+          s >> eng;
+          return bool(in) && bool(s);
+        }
     };
 
+  /**
+   * @brief xoshiro256** random numbers with one stream per OpenMP thread
+   *
+   * Each thread draws from its own generator so that no locking is needed
+   * in parallel regions. Thread `k` uses the seeded state advanced by `k`
+   * jumps of 2^128 numbers and the streams hence never overlap. Outside
+   * parallel regions stream 0 is used and the sequence is thus identical for
+   * a given seed, regardless of the number of threads.
+   *
+   * Parallel loops that must be reproducible also when the thread count
+   * changes should not rely on the per-thread streams but instead draw from
+   * `stream(k)`, where `k` is the loop index or work item. This is a
+   * counter-based generator, seeded by hashing the seed together with `k`:
+   *
+   * ~~~~
+   * #pragma omp parallel for
+   * for (int k=0; k<n; k++) {
+   *   auto eng = slp_global.stream(k);
+   *   double x = eng.uniform();
+   *   ...
+   * }
+   * ~~~~
+   *
+   * @note The number of per-thread streams is set by `seed()` from
+   *       `omp_get_max_threads()`. Threads beyond this number share an extra
+   *       stream guarded by a critical section, so re-seed if the number of
+   *       threads is increased.
+   * @date Lund, 2014
+   */
+  class RandomXoshiro : public RandomBase {
+    public:
+      /** @brief xoshiro256** engine */
+      struct Engine {
+        uint64_t s[4];
+        uint64_t pad[4];        //!< Keep engines on separate cache lines
+        uint64_t operator()();  //!< Next 64 bit integer
+        void jump();            //!< Advance 2^128 numbers
+        inline double uniform() { return ((*this)() >> 11) * 1.1102230246251565e-16; } //!< Number in `[0:1[`
+      };
+    private:
+      int _seed;
+      std::vector<Engine> streams;  //!< One engine per thread
+      Engine overflow;              //!< Shared engine for threads without a stream
+      double _randone();
+    public:
+      RandomXoshiro();
+      void seed(int=0);
+      void save(std::ostream&);
+      bool load(std::istream&);
+      Engine stream(uint64_t) const; //!< Independent stream for work item `k`
+  };
+
 #if defined(MERSENNETWISTER)
   typedef Faunus::RandomTwister<double,std::mt19937> slump;
-#else
+#elif defined(RANDOMRAN2)
   typedef Faunus::RandomRan2 slump;
+#else
+  typedef Faunus::RandomXoshiro slump;
 #endif
   extern slump slp_global;
 }
@@ -9,6 +9,68 @@
 
 namespace Faunus {
 
+  /**
+   * @brief Structure-of-arrays copy of a particle vector
+   *
+   * Positions, charges, radii and particle id's are stored in separate,
+   * contiguous (and aligned) arrays. This allows for energy loops that
+   * read only the properties they need and that can be vectorized
+   * by the compiler and Eigen.
+   */
+  struct ParticleArrays {
+    Eigen::ArrayXd x, y, z;               //!< Positions
+    Eigen::ArrayXd charge;                //!< Charges
+    Eigen::ArrayXd radius;                //!< Radii
+    std::vector<particle::Tid> id;        //!< Particle id's
+
+    inline int size() const { return id.size(); }
+
+    inline void set(int i, const particle &a) {
+      x[i]=a.x();
+      y[i]=a.y();
+      z[i]=a.z();
+      charge[i]=a.charge;
+      radius[i]=a.radius;
+      id[i]=a.id;
+    }
+
+    void update(const p_vec&);            //!< Resize and copy all particles
+  };
+
+  /**
+   * @brief Changes made to `Space::trial` by a trial move
+   *
+   * Filled in by `Move::Movebase` derivatives during `_trialMove()` and
+   * handed to the energy classes on trial, accept and reject (see
+   * `Energy::Energybase::trialUpdate()`) so that stateful energy terms can
+   * be updated incrementally. Only particles in `index` differ between
+   * `Space::p` and `Space::trial`. If `all()` is true, any particle or
+   * property of the system may have changed and incremental updates
+   * should be abandoned.
+   *
+   * Example:
+   *
+   *     Change c;
+   *     c.insert(7);      // particle 7 was displaced
+   *     c.insert(mygroup);// all particles in group, and its mass center, were moved
+   */
+  struct Change {
+    std::set<int> index;         //!< Changed particles (empty=unknown)
+    std::set<Group*> groups;     //!< Moved groups (with updated `Group::cm_trial`)
+    bool volume;                 //!< True if the volume was changed
+    bool count;                  //!< True if particles are inserted or deleted
+
+    Change();
+    void clear();                //!< Reset to no changes
+    bool all() const;            //!< True if changes are unknown or affect all particles
+    void insert(int);            //!< Add changed particle
+    void insert(Group&);         //!< Add moved group and its particles
+
+    /** @brief Add range of changed particles */
+    template<class Titer>
+      void insert(Titer begin, Titer end) { index.insert(begin,end); }
+  };
+
   /**
    * @brief Place holder for particles and groups
    *
@@ -26,6 +88,8 @@ namespace Faunus {
       bool overlap(const particle&) const;   //!< Check hardspheres overlap with particle
       bool checkSanity();                    //!< Check group length and vector sync
       std::vector<Group*> g;                 //!< Pointers to ALL groups in the system
+      bool usearrays;                        //!< True if ParticleArrays mirrors are kept in sync
+      unsigned int nload;                    //!< Number of successful calls to `load()`
 
     public:
       enum keys {OVERLAP,NOOVERLAP,RESIZE,NORESIZE};
@@ -33,23 +97,40 @@ namespace Faunus {
       p_vec p;                                   //!< Main particle vector
       p_vec trial;                               //!< Trial particle vector. 
       std::vector<Group*>& groupList();          //!< Vector with pointers to all groups
+      ParticleArrays p_arr;                      //!< Structure-of-arrays mirror of `p` (if enabled)
+      ParticleArrays trial_arr;                  //!< Structure-of-arrays mirror of `trial` (if enabled)
 
       Space(Geometry::Geometrybase&);
       virtual ~Space();
 
       virtual bool save(string);                      //!< Save container state to disk
       virtual bool load(string, keys=NORESIZE);       //!< Load container state from disk
+      void save(std::ostream&);                       //!< Write binary state to stream
+      bool load(std::istream&);                       //!< Read binary state from stream
+      inline unsigned int loadCount() const { return nload; } //!< Number of times the state was loaded
 
       GroupMolecular insert(const p_vec&, int=-1);
       bool insert(const particle&, int=-1);           //!< Insert particle at pos n (old n will be pushed forward).
       bool insert(string, int, keys=NOOVERLAP); 
       bool erase(int);                                //!< Remove n'th particle
+      bool eraseSwap(int, Group&);                    //!< Remove particle in atomic group by moving in last particle of group
       int enroll(Group&);                             //!< Store group pointer
       void reserve(int);                              //!< Reserve space for particles for better memory efficiency
 
       double charge() const;                          //!< Sum all charges
       string info();                                  //!< Information string
       void displace(const Point&);                    //!< Displace system by a vector
+
+      void enableArrays(bool=true);                   //!< Enable structure-of-arrays mirrors of `p` and `trial`
+      inline bool arraysEnabled() const { return usearrays; } //!< True if mirrors are enabled
+      const ParticleArrays* arrays(const p_vec&) const;//!< Mirror of `p` or `trial` (`nullptr` if unavailable)
+      void syncArrays();                              //!< Full update of mirrors
+      void syncArrays(int);                           //!< Update mirrors for a single particle
+      void syncArrays(const std::set<int>&);          //!< Update mirrors for particles (empty=all)
+      void syncArrays(const Change&);                 //!< Update mirrors for changed particles
+
+      void accept(const Change&);                     //!< Copy changed particles and mass centers from trial
+      void undo(const Change&);                       //!< Restore changed particles and mass centers in trial
   };
 } //namespace
 #endif
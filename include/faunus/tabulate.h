@@ -12,6 +12,7 @@
 #include <algorithm>
 #include <cmath>
 #include <memory>
+#include <stdexcept>
 
 #include <faunus/potentials.h>
 
@@ -1113,6 +1114,167 @@ namespace Faunus {
         }
       };
 
+    /**
+     * @brief Cubic Hermite spline on an equidistant grid in r2
+     *
+     * The interval is calculated directly from r2 so that no search is
+     * needed and `eval()` is free of branches. Two extra intervals hold
+     * constant values below `rmin` and above `rmax`. The grid is refined
+     * by halving the spacing until the tolerances are met (which requires
+     * more memory than the adaptive tabulators for steep functions).
+     * Use the array version of `eval()` to evaluate a batch of r2 values.
+     */
+    template<typename T=double>
+      class Equidistant : public TabulatorBase<T> {
+        private:
+          typedef TabulatorBase<T> base; // for convenience
+          int mngrid;                    // Max number of intervals
+
+        public:
+          struct data {
+            std::vector<T> r2;  // r2 for grid points
+            std::vector<T> c;   // 4 coefficients per interval (below, n intervals, above)
+            T rmin2, rmax2;     // useful to save these with table
+            T invdz;            // inverse grid spacing in r2
+            int n;              // number of intervals in range
+          };
+
+        private:
+          // Hermite coefficients in normalized interval coordinate
+          void setInterval(T *c, T f0, T f1, T df0, T df1, T h) const {
+            c[0] = f0;
+            c[1] = h*df0;
+            c[2] = 3*(f1-f0) - h*(2*df0+df1);
+            c[3] = 2*(f0-f1) + h*(df0+df1);
+          }
+
+          void setConstant(T *c, T u) const {
+            c[0]=u;
+            c[1]=c[2]=c[3]=0;
+          }
+
+          data fill(std::function<T(T)> &f, T rmin2, T rmax2, int n) const {
+            data d;
+            d.n = n;
+            d.rmin2 = rmin2;
+            d.rmax2 = rmax2;
+            T h = (rmax2-rmin2)/n;
+            d.invdz = 1/h;
+            d.r2.resize(n+1);
+            d.c.resize(4*(n+2));
+            for (int i=0; i<=n; i++)
+              d.r2[i] = rmin2 + i*h;
+            T f0=f(d.r2[0]), df0=base::f1(f,d.r2[0]);
+            for (int i=0; i<n; i++) {
+              T f1=f(d.r2[i+1]), df1=base::f1(f,d.r2[i+1]);
+              setInterval(&d.c[4*(i+1)], f0, f1, df0, df1, h);
+              f0=f1;
+              df0=df1;
+            }
+            setConstant(&d.c[0], d.c[4]);
+            setConstant(&d.c[4*(n+1)], f0);
+            return d;
+          }
+
+          bool accurate(const data &d, std::function<T(T)> &f) const {
+            for (int i=0; i<d.n; i++)
+              for (T t : {0.25, 0.5, 0.75}) {
+                T r2 = d.r2[i] + t/d.invdz;
+                if (std::abs(eval(d,r2)-f(r2)) > base::utol)
+                  return false;
+                if (base::ftol != -1) {
+                  const T *c=&d.c[4*(i+1)];
+                  T df = (c[1]+t*(2*c[2]+t*3*c[3]))*d.invdz;
+                  if (std::abs(df-base::f1(f,r2)) > base::ftol)
+                    return false;
+                }
+              }
+            return true;
+          }
+
+        public:
+          Equidistant() : base() {
+            mngrid = 1<<20;
+          }
+
+          /**
+           * @brief Get tabulated value at f(x)
+           * @param d Table data
+           * @param r2 x value
+           */
+          inline T eval(const data& d, T r2) const {
+            T z = (r2-d.rmin2)*d.invdz + 1;
+            z = std::min( std::max(z,T(0)), T(d.n+1) );
+            int i = int(z);
+            T t = z-i;
+            const T *c = &d.c[4*i];
+            return c[0]+t*(c[1]+t*(c[2]+t*c[3]));
+          }
+
+          /**
+           * @brief Get tabulated values for an array of x values
+           * @param d Table data
+           * @param r2 x values
+           * @param u Tabulated values (output)
+           * @param n Number of values
+           */
+          void eval(const data& d, const T *r2, T *u, int n) const {
+            for (int j=0; j<n; j++)
+              u[j]=eval(d,r2[j]);
+          }
+
+          /**
+           * @brief Tabulate f(x)
+           *
+           * Values below/above the range are set to the value at `rmin`/`rmax`.
+           * If `umaxtol` is set, `rmin` is increased until the function is below
+           * this value.
+           *
+           * @throw std::runtime_error if the tolerances are not met with the
+           *        maximum number of intervals
+           */
+          data generate(std::function<T(T)> f) {
+            base::check();
+            T rmin=base::rmin;
+            if (base::umaxtol != -1) {
+              T dr=(base::rmax-base::rmin)/1000;
+              while (rmin+dr<base::rmax && std::abs(f(rmin*rmin))>base::umaxtol)
+                rmin+=dr;
+            }
+            data d;
+            for (int n=16; n<=mngrid; n*=2) {
+              d = fill(f, rmin*rmin, base::rmax*base::rmax, n);
+              if (accurate(d,f))
+                return d;
+            }
+            throw std::runtime_error("Tabulation did not converge. Try to increase utol/ftol");
+          }
+
+          /**
+           * @brief Tabulate f(x) assuming zero above `rmax` and infinity below `rmin`
+           */
+          data generate_full(std::function<T(T)> f) {
+            data d = generate(f);
+            setConstant(&d.c[0], 100000);
+            setConstant(&d.c[4*(d.n+1)], 0);
+            return d;
+          }
+
+          data generate_empty() {
+            std::function<T(T)> f = [](T) { return T(0); };
+            return fill(f, 0, 1e10, 1);
+          }
+
+          std::string print(data &d) {
+            std::ostringstream o;
+            o << "Number of intervals: " << d.n << endl
+              << "rmax2 r2=" << d.rmax2 << " r=" << sqrt(d.rmax2) << endl
+              << "rmin2 r2=" << d.rmin2 << " r=" << sqrt(d.rmin2) << endl
+              << "dr2=" << 1/d.invdz << endl;
+            return o.str();
+          }
+      };
+
   } //Tabulate namespace
 
 #ifdef FAUNUS_POTENTIAL_H
@@ -1157,14 +1319,20 @@ namespace Faunus {
     /**
      * @brief Similar to PotentialTabulate but faster
      *
-     * All pair-potentials are tabulated in constructor
+     * All pair-potentials are tabulated in constructor, one table per
+     * unordered pair of particle types. A flat `ntypes x ntypes` array,
+     * indexed directly by the particle ids, points to the tables. The
+     * default `Tabulate::Equidistant` tabulator finds the interval without
+     * searching and `batch()` evaluates a whole structure-of-arrays segment,
+     * see `Energy::NonbondedArrays`.
      */
-    template<typename Tpairpot, typename Ttabulator=Tabulate::Andrea<double> >
+    template<typename Tpairpot, typename Ttabulator=Tabulate::Equidistant<double> >
       class PotentialTabulateVec : public Tpairpot {
         private:
           Ttabulator tab;
           typedef opair<int> Tpair;
-          vector<typename Ttabulator::data> vtab;
+          vector<typename Ttabulator::data> vtab; // one table per unordered pair
+          vector<int> ndx;                        // index in vtab for all ordered pairs
           unsigned int atomlistsize;
           int print;
 
@@ -1180,33 +1348,38 @@ namespace Faunus {
                 in.get<double>("tab_fmaxtol", -1));
             print = in.get<int>("tab_print",0);
 
-            // Filling up matrix of tabulated data
+            // Filling up matrix of tabulated data - symmetric so each pair only once
             atomlistsize = atom.list.size();
+            ndx.resize(atomlistsize*atomlistsize);
+            vtab.reserve(atomlistsize*(atomlistsize+1)/2);
             for (auto &i : atom.list) {
               for (auto &j : atom.list) {
+                if (j.id<i.id)
+                  continue;
                 particle a,b;
                 a = i;
                 b = j;
                 std::function<double(double)> func = [=](double r2) {return Tpairpot(*this)(a,b,r2);};
-                typename Ttabulator::data td = tab.generate_full(func);
-                vtab.push_back(td);
+                vtab.push_back( tab.generate_full(func) );
+                ndx[a.id*atomlistsize+b.id] = ndx[b.id*atomlistsize+a.id] = vtab.size()-1;
+                auto &d = vtab.back();
                 if (print > 1) {
                   int n = print;
-                  if (vtab[a.id*atomlistsize+b.id].r2.size() > 2) {
+                  if (d.r2.size() > 2) {
                     cout << i.name << "<->" << j.name << " r2.size() "
-                      << vtab[a.id*atomlistsize+b.id].r2.size() << endl;
+                      << d.r2.size() << endl;
                     std::ofstream ff1(std::string(i.name+"."+j.name+".real.dat").c_str());
                     ff1.precision(10);
 
                     std::ofstream ff2(std::string(i.name+"."+j.name+".tab.dat").c_str());
                     ff2.precision(10);
-                    double max = vtab[a.id*atomlistsize+b.id].r2.at(vtab[a.id*atomlistsize+b.id].r2.size()-2);
-                    double min = vtab[i.id*atomlistsize+j.id].r2.at(1);
+                    double max = d.r2.at(d.r2.size()-2);
+                    double min = d.r2.at(1);
                     double dr = (max-min)/(double)n;
                     for (int k=0; k<n; k++) {
                       double r2 = min+dr*((double)k)+0.0000000000001;
                       ff1 << sqrt(r2) << " " << Tpairpot(*this)(a,b,r2) << endl;
-                      ff2 << sqrt(r2) << " " << tab.eval(vtab[a.id*atomlistsize+b.id], r2) << endl;
+                      ff2 << sqrt(r2) << " " << tab.eval(d, r2) << endl;
                     }
                   }
                 }
@@ -1215,10 +1388,26 @@ namespace Faunus {
           }
 
           double operator()(const particle &a, const particle &b, double r2) {
-            return tab.eval(vtab[a.id*atomlistsize+b.id], r2);
+            return tab.eval(vtab[ ndx[a.id*atomlistsize+b.id] ], r2);
           }
+
+          /**
+           * @brief Add energies of `a` with `n` particles in a structure-of-arrays
+           *
+           * Same signature as `Coulomb::batch()`, for example.
+           */
+          template<class Tparticle, class Tarrays>
+            void batch(const Tparticle &a, const Tarrays &b, int first, int n,
+                const double *r2, double *u) const {
+              const int *row = &ndx[a.id*atomlistsize];
+              for (int j=0; j<n; j++)
+                u[j] += tab.eval(vtab[ row[ b.id[first+j] ] ], r2[j]);
+            }
       };
 
+    template<class Tpairpot, class Ttabulator>
+      struct has_batch<PotentialTabulateVec<Tpairpot,Ttabulator> > : std::true_type {};
+
     /**
      * @brief Custom tabulated potentials between specific particle types
      *
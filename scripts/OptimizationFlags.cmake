@@ -1,5 +1,6 @@
 # Compiler specific optimization flags.
 # - Set ENABLE_OPENMP to enable OpenMP support
+# - Set ENABLE_NATIVE to optimize and vectorize for the host CPU
 # $Mikael Lund, 2008
 # See http://fedetft.wordpress.com/2009/12/21/cmake-part-2-compiler-flags/
 unset(CMAKE_CXX_FLAGS)
@@ -18,6 +19,14 @@ elseif (CMAKE_CXX_COMPILER_ID MATCHES "pathCC")
   set(CMAKE_CXX_FLAGS "")
 endif()
 
+if (ENABLE_NATIVE)
+  if (CMAKE_CXX_COMPILER_ID MATCHES "GNU")
+    set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -march=native -fvect-cost-model=dynamic")
+  elseif (CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+    set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -march=native")
+  endif()
+endif()
+
 if (ENABLE_OPENMP)
   find_package(OpenMP)
   if (OPENMP_FOUND)
@@ -5,6 +5,7 @@
 #include <faunus/inputfile.h>
 #include <faunus/geometry.h>
 #include <faunus/textio.h>
+#include <faunus/checkpoint.h>
 
 namespace Faunus {
 
@@ -28,6 +29,26 @@ namespace Faunus {
       _test(t);
     }
 
+    void AnalysisBase::_save(std::ostream&) {}
+
+    bool AnalysisBase::_load(std::istream&) { return true; }
+
+    /**
+     * Writes the number of samples and the runfraction, followed by
+     * accumulators of derived classes via `_save()`.
+     */
+    void AnalysisBase::save(std::ostream &o) {
+      Binary::write(o,cnt);
+      Binary::write(o,runfraction);
+      _save(o);
+    }
+
+    bool AnalysisBase::load(std::istream &in) {
+      Binary::read(in,cnt);
+      Binary::read(in,runfraction);
+      return _load(in) && bool(in);
+    }
+
     string AnalysisBase::info() {
       assert(!name.empty() && "Please name analysis.");
       using namespace textio;
@@ -303,6 +324,17 @@ namespace Faunus {
         t("PolymerShape_Rg"+m.first, Rg[m.first].avg() );
     }
 
+    void PolymerShape::_save(std::ostream &o) {
+      for (auto m : {&Rg2, &Rg, &Re2, &Rs, &Rs2, &Rg2x, &Rg2y, &Rg2z})
+        Binary::write(o,*m);
+    }
+
+    bool PolymerShape::_load(std::istream &in) {
+      for (auto m : {&Rg2, &Rg, &Re2, &Rs, &Rs2, &Rg2x, &Rg2y, &Rg2z})
+        Binary::read(in,*m);
+      return bool(in);
+    }
+
     ChargeMultipole::ChargeMultipole(){
       name="Multipole";
     }
@@ -353,6 +385,17 @@ namespace Faunus {
       mu2[g.name]+=pow(dip,2);
     }
 
+    void ChargeMultipole::_save(std::ostream &o) {
+      for (auto m : {&Z, &Z2, &mu, &mu2})
+        Binary::write(o,*m);
+    }
+
+    bool ChargeMultipole::_load(std::istream &in) {
+      for (auto m : {&Z, &Z2, &mu, &mu2})
+        Binary::read(in,*m);
+      return bool(in);
+    }
+
     string ChargeMultipole::_info(){
       using namespace textio;
       char k=13;
@@ -419,6 +462,15 @@ namespace Faunus {
       test("widom_muex", muex() );
     }
 
+    void Widom::_save(std::ostream &o) {
+      Binary::write(o,expsum);
+    }
+
+    bool Widom::_load(std::istream &in) {
+      Binary::read(in,expsum);
+      return bool(in);
+    }
+
     string Widom::_info() {
       using namespace Faunus::textio;
       std::ostringstream o;
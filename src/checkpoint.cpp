@@ -0,0 +1,128 @@
+#include <faunus/checkpoint.h>
+#include <faunus/point.h>
+#include <faunus/textio.h>
+#include <cstdio>
+#include <algorithm>
+
+namespace Faunus {
+
+  namespace {
+    const char magic[8] = {'F','A','U','N','U','S','C','P'};
+    const uint32_t endian = 0x01020304;
+  }
+
+  const uint32_t Checkpoint::version;
+
+  Checkpoint::Checkpoint(string filename) : cntsave(0), file(filename) {}
+
+  /**
+   * @param key Unique section name
+   * @param s Function that writes the state to a binary stream
+   * @param l Function that restores the state from a binary stream
+   */
+  void Checkpoint::add(string key, Tsave s, Tload l) {
+    assert( std::none_of(reg.begin(), reg.end(),
+          [&key](const entry &e) { return e.key==key; }) && "checkpoint keys must be unique");
+    reg.push_back( {key,s,l} );
+  }
+
+  /**
+   * The sections are written to `file.tmp` which is subsequently renamed to
+   * `file`, replacing any previous checkpoint.
+   */
+  bool Checkpoint::save() {
+    string tmp=file+".tmp";
+    std::ofstream f(tmp.c_str(), std::ios::binary);
+    if (f) {
+      f.write(magic, sizeof(magic));
+      Binary::write(f, version);
+      Binary::write(f, endian);
+      Binary::write(f, uint32_t(sizeof(particle)));
+      Binary::write(f, uint64_t(reg.size()));
+      for (auto &e : reg) {
+        std::ostringstream o(std::ios::binary);
+        e.save(o);
+        Binary::write(f, e.key);
+        Binary::write(f, o.str());
+      }
+      f.close();
+      if (f && std::rename(tmp.c_str(), file.c_str())==0) {
+        cntsave++;
+        return true;
+      }
+    }
+    std::cerr << "Error writing checkpoint file '" << file << "'.\n";
+    return false;
+  }
+
+  /**
+   * Loading is all or nothing: if a registered section is missing in the
+   * file or fails to load, all registered objects are restored to their
+   * state before the call and `false` is returned.
+   */
+  bool Checkpoint::load() {
+    std::ifstream f(file.c_str(), std::ios::binary);
+    if (!f)
+      return false;
+    char m[sizeof(magic)];
+    uint32_t ver=0, end=0, psize=0;
+    uint64_t n=0;
+    f.read(m, sizeof(m));
+    Binary::read(f, ver);
+    Binary::read(f, end);
+    Binary::read(f, psize);
+    Binary::read(f, n);
+    if (!f || !std::equal(m, m+sizeof(m), magic) || ver!=version
+        || end!=endian || psize!=sizeof(particle)) {
+      std::cerr << "Checkpoint file '" << file << "' is incompatible.\n";
+      return false;
+    }
+    std::map<string,string> sections;
+    for (uint64_t i=0; i<n && f; i++) {
+      string key;
+      Binary::read(f, key);
+      Binary::read(f, sections[key]);
+    }
+    if (!f) {
+      std::cerr << "Checkpoint file '" << file << "' is truncated.\n";
+      return false;
+    }
+    for (auto &e : reg)
+      if (sections.find(e.key)==sections.end()) {
+        std::cerr << "Checkpoint section '" << e.key << "' not found.\n";
+        return false;
+      }
+
+    // snapshot of current state to restore upon failure
+    std::vector<string> backup;
+    for (auto &e : reg) {
+      std::ostringstream o(std::ios::binary);
+      e.save(o);
+      backup.push_back(o.str());
+    }
+    for (auto &e : reg) {
+      std::istringstream in(sections[e.key], std::ios::binary);
+      if (!e.load(in) || !in) {
+        std::cerr << "Error reading checkpoint section '" << e.key << "'. Nothing restored.\n";
+        for (size_t i=0; i<reg.size(); i++) {
+          std::istringstream b(backup[i], std::ios::binary);
+          reg[i].load(b);
+        }
+        return false;
+      }
+    }
+    return true;
+  }
+
+  string Checkpoint::info() {
+    using namespace textio;
+    char w=25;
+    std::ostringstream o;
+    o << header("Checkpoint")
+      << pad(SUB,w,"File") << file << endl
+      << pad(SUB,w,"Sections") << reg.size() << endl
+      << pad(SUB,w,"Number of saves") << cntsave << endl;
+    return o.str();
+  }
+
+}//namespace
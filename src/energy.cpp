@@ -5,9 +5,20 @@
 #include <faunus/textio.h>
 #include <faunus/space.h>
 #include <faunus/species.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace Faunus {
   namespace Energy {
+    int ompThreads(int n, int minpairs) {
+#ifdef _OPENMP
+      return std::max(1, std::min(omp_get_max_threads(), n/minpairs));
+#else
+      return 1;
+#endif
+    }
+
     Energybase::Energybase() : geo(nullptr) {
       w=25;
     }
@@ -56,6 +67,26 @@ namespace Faunus {
       return i2all(p,i) + i_external(p,i) + i_internal(p,i);
     }
 
+    double Energybase::i2all_change(const p_vec &pnew, const p_vec &pold, int i) {
+      return i2all(pnew,i) - i2all(pold,i);
+    }
+
+    /**
+     * Equivalent to `i_total(pnew,i)-i_total(pold,i)` but the pair
+     * contribution is evaluated via `i2all_change()`. External and internal
+     * energies of the new configuration are evaluated first so that infinite
+     * energies are caught before the more expensive pair sum.
+     */
+    double Energybase::i_total_change(const p_vec &pnew, const p_vec &pold, int i) {
+      double u=i_external(pnew,i);
+      if (u>=pc::infty)
+        return pc::infty;       // early rejection
+      u+=i_internal(pnew,i);
+      if (u>=pc::infty)
+        return pc::infty;       // early rejection
+      return u + i2all_change(pnew,pold,i) - i_external(pold,i) - i_internal(pold,i);
+    }
+
     // Group interactions
     double Energybase::g2g(const p_vec &p, Group &g1, Group &g2) {return 0;}
     double Energybase::g2all(const p_vec &p, Group &g) {return 0;}
@@ -63,6 +94,17 @@ namespace Faunus {
     double Energybase::g_internal(const p_vec &p, Group &g) {return 0;}
 
     double Energybase::external() {return 0;}
+
+    /**
+     * Adds to `m[n]` the part of `all2all(p)` that is proportional to
+     * \f$r^{-n}\f$ so that if all distances are scaled by a factor
+     * \f$s\f$, the pair energy becomes \f$\sum_n m[n]s^{-n}\f$. Returns
+     * `false` if the energy cannot be decomposed in this way, which is
+     * the default. Classes with no pair energy should return `true`.
+     * The return value may not depend on `p` so that an empty vector can
+     * be used to test if the decomposition is available.
+     */
+    bool Energybase::all2all_powers(const p_vec &p, std::map<int,double> &m) { return false; }
     void Energybase::field(const p_vec &p, std::vector<Point> &E) {}
 
     string Energybase::info() {
@@ -102,6 +144,121 @@ namespace Faunus {
       return o.str();
     }
 
+    GroupPairCache::GroupPairCache(Space &s, Energybase &e) : spc(&s), pot(&e) {
+      trialrow=-1;
+      intrial=false;
+      nload=s.loadCount();
+    }
+
+    int GroupPairCache::groupIndex(const Group &g) {
+      auto &l=spc->groupList();
+      for (size_t i=0; i<l.size(); i++)
+        if (l[i]==&g)
+          return i;
+      assert(!"Group not found in Space");
+      return -1;
+    }
+
+    void GroupPairCache::invalidate() {
+      stale.assign(stale.size(), true);
+    }
+
+    void GroupPairCache::refresh() {
+      auto &l=spc->groupList();
+      int n=l.size();
+      if (u.rows()!=n) {
+        u.setZero(n,n);
+        stale.assign(n, true);
+      }
+      if (nload!=spc->loadCount()) {
+        nload=spc->loadCount();
+        invalidate();
+      }
+      vector<bool> done=stale;
+      for (int i=0; i<n; i++)
+        if (stale[i]) {
+          for (int j=0; j<n; j++)
+            if (j!=i && !(done[j] && j<i)) // pairs of stale rows only once
+              u(i,j) = u(j,i) = pot->g2g(spc->p, *l[i], *l[j]);
+          stale[i]=false;
+        }
+    }
+
+    double GroupPairCache::row(Group &g) {
+      refresh();
+      return u.row( groupIndex(g) ).sum();
+    }
+
+    /**
+     * The energy row is stored and copied into the cache if the move
+     * is accepted. Returns infinity as soon as a single group pair
+     * energy is infinite (early rejection).
+     */
+    double GroupPairCache::trialRow(const p_vec &p, Group &g) {
+      refresh();
+      auto &l=spc->groupList();
+      int n=l.size(), k=groupIndex(g);
+      utrial.setZero(n);
+      trialrow=-1;
+      double sum=0;
+      for (int j=0; j<n; j++)
+        if (j!=k) {
+          utrial[j] = pot->g2g(p, *l[j], g);
+          sum+=utrial[j];
+          if (sum==pc::infty)
+            return pc::infty;
+        }
+      trialrow=k;
+      return sum;
+    }
+
+    double GroupPairCache::g2g(Group &g1, Group &g2) {
+      refresh();
+      return u( groupIndex(g1), groupIndex(g2) );
+    }
+
+    double GroupPairCache::total() {
+      refresh();
+      return 0.5*u.sum();
+    }
+
+    void GroupPairCache::trialUpdate(const Change&) {
+      trialrow=-1;
+      intrial=true;
+    }
+
+    /**
+     * The trial row, if any, is copied into the cache. Other groups
+     * with changed particles are marked for recalculation. If the
+     * changed particles are unknown, all groups are recalculated.
+     */
+    void GroupPairCache::acceptUpdate(const Change &c) {
+      if (!intrial)
+        return;
+      auto &l=spc->groupList();
+      auto &index=c.index;
+      if (c.all() || u.rows()!=int(l.size()))
+        invalidate();
+      else {
+        if (trialrow>=0) {
+          u.row(trialrow) = utrial.transpose();
+          u.col(trialrow) = utrial;
+        }
+        for (size_t i=0; i<l.size(); i++)
+          if (int(i)!=trialrow && !l[i]->empty()) {
+            auto it=index.lower_bound( l[i]->front() );
+            if (it!=index.end() && *it<=l[i]->back())
+              stale[i]=true;
+          }
+      }
+      rejectUpdate(c);
+    }
+
+    void GroupPairCache::rejectUpdate(const Change&) {
+      trialrow=-1;
+      intrial=false;
+    }
+
     Hamiltonian::Hamiltonian() {
       name="Hamiltonian";
     }
@@ -127,6 +284,14 @@ namespace Faunus {
       baselist.push_back( &e );
     }
 
+    /**
+     * All moves acting on `spc` must call the trial/accept/reject hooks
+     * of this Hamiltonian (default for `Move::Movebase` derivatives).
+     */
+    void Hamiltonian::enableGroupCache(Space &spc) {
+      gcache = std::make_shared<GroupPairCache>(spc, *this);
+    }
+
     void Hamiltonian::setVolume(double vol) {
       for (auto e : baselist )
         e->setVolume(vol);
@@ -161,8 +326,11 @@ namespace Faunus {
 
     double Hamiltonian::all2p(const p_vec &p, const particle &a) {
       double u=0;
-      for (auto b : baselist)
+      for (auto b : baselist) {
         u += b->all2p( p,a );
+        if (u>=pc::infty)
+          break;
+      }
       return u;
     }
 
@@ -176,43 +344,71 @@ namespace Faunus {
 
     double Hamiltonian::i2g(const p_vec &p, Group &g, int i) {
       double u=0;
-      for (auto b : baselist)
+      for (auto b : baselist) {
         u += b->i2g(p,g,i);
+        if (u>=pc::infty)
+          break;
+      }
       return u;
     }
 
     double Hamiltonian::i2all(const p_vec &p, int i) {
       double u=0;
-      for (auto b : baselist)
+      for (auto b : baselist) {
         u += b->i2all(p,i);
+        if (u>=pc::infty)
+          break;
+      }
+      return u;
+    }
+
+    double Hamiltonian::i2all_change(const p_vec &pnew, const p_vec &pold, int i) {
+      double u=0;
+      for (auto b : baselist) {
+        u += b->i2all_change(pnew,pold,i);
+        if (u>=pc::infty)
+          break;
+      }
       return u;
     }
 
     double Hamiltonian::i_external(const p_vec &p, int i) {
       double u=0;
-      for (auto b : baselist)
+      for (auto b : baselist) {
         u += b->i_external(p,i);
+        if (u>=pc::infty)
+          break;
+      }
       return u;
     }
     double Hamiltonian::i_internal(const p_vec &p, int i) {
       double u=0;
-      for (auto b : baselist)
+      for (auto b : baselist) {
         u += b->i_internal(p,i);
+        if (u>=pc::infty)
+          break;
+      }
       return u;
     }
 
     // Group interactions
     double Hamiltonian::g2g(const p_vec &p, Group &g1, Group &g2) {
       double u=0;
-      for (auto b : baselist)
+      for (auto b : baselist) {
         u += b->g2g(p,g1,g2);
+        if (u>=pc::infty)
+          break;
+      }
       return u;
     }
 
     double Hamiltonian::g2all(const p_vec &p, Group &g) {
       double u=0;
-      for (auto b : baselist)
+      for (auto b : baselist) {
         u += b->g2all(p,g);
+        if (u>=pc::infty)
+          break;
+      }
       return u;
     }
 
@@ -236,8 +432,11 @@ namespace Faunus {
 
     double Hamiltonian::g_internal(const p_vec &p, Group &g) {
       double u=0;
-      for (auto b : baselist)
+      for (auto b : baselist) {
         u += b->g_internal(p,g);
+        if (u>=pc::infty)
+          break;
+      }
       return u;
     }
 
@@ -248,6 +447,13 @@ namespace Faunus {
       return u;
     }
 
+    bool Hamiltonian::all2all_powers(const p_vec &p, std::map<int,double> &m) {
+      for (auto b : baselist)
+        if (!b->all2all_powers(p,m))
+          return false;
+      return true;
+    }
+
     double Hamiltonian::v2v(const p_vec &v1, const p_vec &v2) {
       double u=0;
       for (auto b : baselist)
@@ -273,13 +479,34 @@ namespace Faunus {
         b->field(p,E);
     }
 
-    Bonded::Bonded() {
+    void Hamiltonian::trialUpdate(const Space &spc, const Change &c) {
+      for (auto b : baselist)
+        b->trialUpdate(spc,c);
+      if (gcache)
+        gcache->trialUpdate(c);
+    }
+
+    void Hamiltonian::acceptUpdate(const Change &c) {
+      for (auto b : baselist)
+        b->acceptUpdate(c);
+      if (gcache)
+        gcache->acceptUpdate(c);
+    }
+
+    void Hamiltonian::rejectUpdate(const Change &c) {
+      for (auto b : baselist)
+        b->rejectUpdate(c);
+      if (gcache)
+        gcache->rejectUpdate(c);
+    }
+
+    Bonded::Bonded() : dirty(false) {
       name="Bonded particles";
       geo=nullptr;
       CrossGroupBonds=false;
     }
 
-    Bonded::Bonded(Geometry::Geometrybase &g) {
+    Bonded::Bonded(Geometry::Geometrybase &g) : dirty(false) {
       name="Bonded particles";
       CrossGroupBonds=false;
       geo=&g;
@@ -287,22 +514,169 @@ namespace Faunus {
 
     string Bonded::_info() {
       using namespace Faunus::textio;
+      if (dirty)
+        build();
       std::ostringstream o;
       o << pad(SUB,30,"Look for group-group bonds:")
-        << (CrossGroupBonds ? "yes (slow)" : "no (faster)") << endl << endl
+        << (CrossGroupBonds ? "yes (slow)" : "no (faster)") << endl
+        << pad(SUB,30,"Number of bonds:") << bonds.size() << endl
+        << pad(SUB,30,"Generic (slow) bonds:") << generic.size() << endl << endl
         << indent(SUBSUB) << std::left
         << setw(7) << "i" << setw(7) << "j" << endl;
-      return o.str() + _infolist;
+      for (size_t n=0; n<bonds.size(); n++)
+        o << indent(SUBSUB) << std::left << setw(7) << bonds[n].i
+          << setw(7) << bonds[n].j << briefs[n] << endl;
+      return o.str();
     }
 
-    /*!
-     * \todo Optimize by using iterator directly as returned by find.
+    /**
+     * If `i` and `j` are already bonded, the existing bond is replaced so
+     * that each pair has at most one bond.
+     */
+    void Bonded::add(int i, int j, Tkind kind, int index, const string &brief) {
+      assert(i!=j && i>=0 && j>=0);
+      auto key=std::make_pair( std::min(i,j), std::max(i,j) );
+      auto it=lookup.find(key);
+      if (it!=lookup.end()) {
+        bonds[it->second] = {i,j,kind,index};
+        briefs[it->second] = brief;
+      } else {
+        lookup[key]=bonds.size();
+        bonds.push_back( {i,j,kind,index} );
+        briefs.push_back(brief);
+      }
+      dirty=true;
+    }
+
+    void Bonded::reindex() {
+      lookup.clear();
+      for (size_t k=0; k<bonds.size(); k++)
+        lookup[ std::make_pair( std::min(bonds[k].i,bonds[k].j), std::max(bonds[k].i,bonds[k].j) ) ] = k;
+    }
+
+    /**
+     * Potentials are kept in the order of first use and the bond
+     * indices are updated accordingly.
+     */
+    template<class T>
+      void Bonded::compact(vector<T> &v, Tkind kind) {
+        vector<int> newindex(v.size(), -1);
+        vector<T> keep;
+        for (auto &b : bonds)
+          if (b.kind==kind) {
+            if (newindex[b.index]<0) {
+              newindex[b.index]=keep.size();
+              keep.push_back( v[b.index] );
+            }
+            b.index=newindex[b.index];
+          }
+        v.swap(keep);
+      }
+
+    void Bonded::add(int i, int j, Potential::Harmonic pot) {
+      string brief=pot.brief();
+      pot.name.clear();
+      pot.prefix.clear();
+      harmonic.push_back(pot);
+      add(i, j, HARMONIC, harmonic.size()-1, brief);
+    }
+
+    void Bonded::add(int i, int j, Potential::FENE pot) {
+      string brief=pot.brief();
+      pot.name.clear();
+      pot.prefix.clear();
+      fene.push_back(pot);
+      add(i, j, FENE, fene.size()-1, brief);
+    }
+
+    /**
+     * Potentials no longer used by any bond - after `erase()` or when a bond
+     * is replaced by `add()` - are removed. The partners of each particle
+     * are counted, the counts are turned into offsets, and the partners are
+     * filled in - all in linear time.
      */
+    void Bonded::build() {
+      compact(harmonic, HARMONIC);
+      compact(fene, FENE);
+      compact(generic, GENERIC);
+      int n=0;
+      for (auto &b : bonds)
+        n=std::max(n, std::max(b.i,b.j)+1);
+      offset.assign(n+1, 0);
+      for (auto &b : bonds) {
+        offset[b.i+1]++;
+        offset[b.j+1]++;
+      }
+      for (int i=0; i<n; i++)
+        offset[i+1]+=offset[i];
+      partners.resize( offset[n] );
+      vector<int> pos(offset.begin(), offset.end()-1);
+      for (size_t k=0; k<bonds.size(); k++) {
+        const Bond &b=bonds[k];
+        partners[ pos[b.i]++ ] = {b.j, int(k)};
+        partners[ pos[b.j]++ ] = {b.i, int(k)};
+      }
+      dirty=false;
+    }
+
+    /**
+     * @param i Index of first inserted particle
+     * @param n Number of inserted particles
+     *
+     * Call this after inserting particles in `Space` so that existing
+     * bonds follow the particles they were made for.
+     */
+    void Bonded::insert(int i, int n) {
+      for (auto &b : bonds) {
+        if (b.i>=i) b.i+=n;
+        if (b.j>=i) b.j+=n;
+      }
+      reindex();
+      dirty=true;
+    }
+
+    /**
+     * Bonds involving particle `i` are removed and higher indices are decreased
+     * by one as done by `Space::erase()`.
+     */
+    void Bonded::erase(int i) {
+      size_t m=0;
+      for (size_t k=0; k<bonds.size(); k++) {
+        Bond b=bonds[k];
+        if (b.i==i || b.j==i)
+          continue;
+        if (b.i>i) b.i--;
+        if (b.j>i) b.j--;
+        bonds[m]=b;
+        briefs[m]=briefs[k];
+        m++;
+      }
+      bonds.resize(m);
+      briefs.resize(m);
+      reindex();
+      dirty=true;
+    }
+
+    int Bonded::size() const { return bonds.size(); }
+
+    void Bonded::clear() {
+      bonds.clear();
+      briefs.clear();
+      harmonic.clear();
+      fene.clear();
+      generic.clear();
+      offset.clear();
+      partners.clear();
+      lookup.clear();
+      dirty=false;
+    }
+
     double Bonded::i2i(const p_vec &p, int i, int j) {
       assert(i!=j);
-      auto f=list.find( opair<int>(i,j) );
-      if (f!=list.end())
-        return f->second( p[i], p[j], geo->sqdist( p[i], p[j] ) );
+      auto r=partnersOf(i);
+      for (auto n=r.first; n!=r.second; ++n)
+        if (n->j==j)
+          return energy(p,i,*n);
       return 0;
     }
 
@@ -310,44 +684,44 @@ namespace Faunus {
       assert(geo!=nullptr);  //debug
       assert( i>=0 && i<(int)p.size() ); //debug
       double u=0;
-      auto eqr=mlist.equal_range(i);
-      for (auto it=eqr.first; it!=eqr.second; ++it) {
-        int j = it->second; // partner index
-        u += list[opair<int>(i,j)]( p[i], p[j], geo->sqdist( p[i], p[j] ) );
-      }
+      auto r=partnersOf(i);
+      for (auto n=r.first; n!=r.second; ++n)
+        u += energy(p,i,*n);
+      return u;
+    }
+
+    /** @brief Bonds between particle `i` and particles in `g` */
+    double Bonded::i2g(const p_vec &p, Group &g, int i) {
+      double u=0;
+      auto r=partnersOf(i);
+      for (auto n=r.first; n!=r.second; ++n)
+        if (g.find(n->j))
+          u += energy(p,i,*n);
       return u;
     }
 
     double Bonded::total(const p_vec &p) {
-      assert(&geo!=nullptr);  //debug
+      assert(geo!=nullptr);  //debug
       double u=0;
-      for (auto &m : list) {
-        int i=m.first.first;
-        int j=m.first.second;
-        assert(i>=0 && i<(int)p.size() && j>=0 && j<(int)p.size()); //debug
-        u += m.second( p[i], p[j], geo->sqdist( p[i], p[j] ) );
+      for (auto &b : bonds) {
+        assert(b.i<(int)p.size() && b.j<(int)p.size()); //debug
+        u += energy( b, p[b.i], p[b.j], geo->sqdist( p[b.i], p[b.j] ) );
       }
       return u;
     }
 
     /**
-     * Group-to-group bonds are disabled by default as these are rarely used and the current
-     * implementation is rather slow for systems with *many* groups (but very general). To
+     * Group-to-group bonds are disabled by default as these are rarely used. To
      * activate `g2g()`, set `CrossGroupBonds=true`.
-     *
-     * @warning Untested!
-     * @todo Possible optimization: swap groups so that `g1<g2`;
      */
     double Bonded::g2g(const p_vec &p, Group &g1, Group &g2) {
       double u=0;
       if (CrossGroupBonds)
         for (auto i : g1) {
-          auto eqr=mlist.equal_range(i);
-          for (auto it=eqr.first; it!=eqr.second; ++it) {
-            int j = it->second; // partner index
-            if (g2.find(j))
-              u+=list[opair<int>(i,j)]( p[i], p[j], geo->sqdist( p[i], p[j] ) );
-          }
+          auto r=partnersOf(i);
+          for (auto n=r.first; n!=r.second; ++n)
+            if (g2.find(n->j))
+              u += energy(p,i,*n);
         }
       return u;
     }
@@ -359,24 +733,11 @@ namespace Faunus {
     double Bonded::g_internal(const p_vec &p, Group &g) {
       assert(geo!=nullptr);  //debug
       double u=0;
-
-      if ( list.size() > pow(g.size(),2) ) {
-        // small group compared to bond list
-        auto end=list.end();
-        for (auto i=g.front(); i<g.back(); i++)
-          for (auto j=i+1; j<=g.back(); j++) {
-            auto it = list.find(opair<int>(i,j));
-            if (it!=end)
-              u+=it->second( p[i],p[j],geo->sqdist( p[i],p[j] ) );
-          }
-      } else {
-        // big group compared to bond list
-        for (auto &m : list) {
-          int i=m.first.first, j=m.first.second;
-          if (g.find(i))
-            if (g.find(j))
-              u += m.second(p[i],p[j],geo->sqdist( p[i],p[j] ));
-        }
+      for (auto i : g) {
+        auto r=partnersOf(i);
+        for (auto n=r.first; n!=r.second; ++n)
+          if (n->j>i && g.find(n->j))
+            u += energy(p,i,*n);
       }
       return u;
     }
@@ -525,10 +886,17 @@ namespace Faunus {
       return o.str();
     }
 
+    /**
+     * If `pot` is a Hamiltonian with an enabled group cache, the group-group
+     * energies of `Space::p` are taken from the cache.
+     */
     double systemEnergy(Space &spc, Energy::Energybase &pot, const p_vec &p) {
       double u = pot.external();
       for (auto g : spc.groupList())
         u += pot.g_external(p, *g) + pot.g_internal(p, *g);
+      auto ham = dynamic_cast<Hamiltonian*>(&pot);
+      if (ham!=nullptr && ham->groupCache()!=nullptr && &p==&spc.p)
+        return u + ham->groupCache()->total();
       for (size_t i=0; i<spc.groupList().size()-1; i++)
         for (size_t j=i+1; j<spc.groupList().size(); j++)
           u += pot.g2g(p, *spc.groupList()[i], *spc.groupList()[j]);
@@ -52,7 +52,10 @@ void MakeDesernoMembrane(const Tlipid &lipid, Tbonded &bond, Tnonbonded &nb, Tin
 }
 
 typedef Geometry::Cuboid Tgeometry;   // specify geometry - here cube w. periodic boundaries
-typedef Potential::PotentialMap<Potential::DebyeHuckelLJ> Tpairpot;
+typedef Potential::CombinedPairPotential<Potential::WeeksChandlerAndersen,Potential::DebyeHuckel> Thead;
+typedef Potential::CombinedPairPotential<Potential::WeeksChandlerAndersen,Potential::CosAttract> Ttail;
+typedef Potential::CombinedPairPotential<Potential::WeeksChandlerAndersen,Potential::ChargeNonpolar> Theadtail;
+typedef Potential::PotentialMatrix<Potential::DebyeHuckelLJ,Thead,Ttail,Theadtail> Tpairpot;
 
 int main() {
 
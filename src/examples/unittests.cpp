@@ -2,6 +2,10 @@
 #define CATCH_CONFIG_MAIN  // This tell CATCH to provide a main() - only do this in one cpp file
 #include <catch/catch.hpp>
 #include <faunus/faunus.h>
+#include <faunus/ewald.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace Faunus;
 
@@ -27,6 +31,13 @@ TEST_CASE("Spline table", "...")
   checkTabulator(Tabulate::AndreaIntel<double>());
   checkTabulator(Tabulate::Andrea<double>());
   checkTabulator(Tabulate::Linear<double>());
+  checkTabulator(Tabulate::Equidistant<double>());
+
+  Tabulate::Equidistant<double> eq;
+  eq.setRange(1, 10);
+  eq.setTolerance(0.01);
+  std::function<double(double)> step = [](double x) { return x<9.9 ? 0. : 1.; };
+  CHECK_THROWS( eq.generate(step) );
 
   PointParticle a,b;
   a.charge=1;
@@ -39,6 +50,29 @@ TEST_CASE("Spline table", "...")
   double error = fabs( pot_org(a,b,5)-pot_tab(a,b,5) ) ;
   CHECK(error>0);
   CHECK(error<0.01);
+
+  auto atoms = atom.list;                  // temporary atom types
+  for (double q : {1,-1}) {
+    AtomData d;
+    d.id = atom.list.size();
+    d.charge = q;
+    d.radius = 2;
+    atom.list.push_back(d);
+  }
+  a = atom[atoms.size()];
+  b = atom[atoms.size()+1];
+  Potential::PotentialTabulateVec<Potential::DebyeHuckelLJ> pot_vec(mcp);
+  atom.list = atoms;
+  CHECK( pot_vec(a,b,30) == Approx(pot_org(a,b,30)).epsilon(0.01) );
+  CHECK( pot_vec(a,b,2e4) == Approx(0) );
+
+  ParticleArrays arr;
+  p_vec v = {a,b,b};
+  arr.update(v);
+  double r2[3] = {5, 30, 400}, u[3] = {0,0,0};
+  pot_vec.batch(a, arr, 0, 3, r2, u);
+  CHECK( u[1] == Approx(pot_vec(a,b,30)) );
+  CHECK( std::abs(u[2]-pot_org(a,b,400)) < 0.01 );
 }
 
 /*
@@ -141,6 +175,48 @@ TEST_CASE("Geometries", "Geometry tests")
   CHECK( x==Approx(y) );
 }
 
+/* compare batched and single distance functions */
+template<typename Tgeometry>
+void checkDistances(Tgeometry &geo) {
+  int n=50;
+  std::vector<Point> p(n);
+  std::vector<double> x(n), y(n), z(n), r2(n);
+  for (int i=0; i<n; i++) {
+    geo.randompos(p[i]);
+    x[i]=p[i].x();
+    y[i]=p[i].y();
+    z[i]=p[i].z();
+  }
+  geo.sqdist(p[0], x.data(), y.data(), z.data(), r2.data(), n);
+  for (int i=0; i<n; i++) {
+    CHECK( r2[i] == Approx(geo.sqdist(p[0],p[i])) );
+    CHECK( geo.vdist(p[0],p[i]).squaredNorm() == Approx(r2[i]) );
+  }
+}
+
+TEST_CASE("Batched distances", "Compare batched and single minimum image distances")
+{
+  InputMap mcp;
+  mcp.add("cuboid_len", 20.);
+  Geometry::Sphere sph(10);
+  Geometry::Cuboid cub(mcp);
+  Geometry::Cuboidslit slit(mcp);
+  Geometry::PeriodicCylinder cyl(20,10);
+  checkDistances(sph);
+  checkDistances(cub);
+  checkDistances(slit);
+  checkDistances(cyl);
+
+  Point a(31,-12,4);
+  cub.boundary(a);
+  CHECK( a.x() == Approx(-9) );
+  CHECK( a.y() == Approx(8) );
+  CHECK( a.z() == Approx(4) );
+  a.z()=-23;
+  cyl.boundary(a);
+  CHECK( a.z() == Approx(-3) );
+}
+
 TEST_CASE("Random numbers", "Check random number generator")
 {
   int min=10, max=0, N=1e7;
@@ -156,6 +232,42 @@ TEST_CASE("Random numbers", "Check random number generator")
   CHECK( std::fabs(x/N) == Approx(4.5).epsilon(0.05) );
 }
 
+TEST_CASE("Random streams", "Check independent and reproducible random streams")
+{
+  RandomXoshiro a, b;
+  a.seed(7);
+  b.seed(7);
+  for (int i=0; i<100; i++)
+    CHECK( a()==b() );
+
+  auto s1=a.stream(1), s1copy=b.stream(1), s2=a.stream(2);
+  int same=0;
+  for (int i=0; i<100; i++) {
+    double x=s1.uniform();
+    CHECK( x==s1copy.uniform() );
+    CHECK( (x>=0 && x<1) );
+    if (x==s2.uniform())
+      same++;
+  }
+  CHECK( same==0 );
+
+#ifdef _OPENMP
+  // more threads than seeded streams
+  int nmax=omp_get_max_threads();
+  omp_set_num_threads(1);
+  a.seed(7);
+  omp_set_num_threads(nmax);
+  int bad=0;
+#pragma omp parallel for num_threads(4) reduction(+:bad)
+  for (int i=0; i<1000; i++) {
+    double x=a();
+    if (x<0 || x>=1)
+      bad++;
+  }
+  CHECK( bad==0 );
+#endif
+}
+
 TEST_CASE("Quaternion", "Check vector rotation")
 {
   Geometry::QuaternionRotate qrot;
@@ -177,3 +289,1165 @@ TEST_CASE("Tables and averages","Check table of averages")
   table(2.1)+=3;
   CHECK( table(2.1).avg() == Approx(2.0) );
 }
+
+TEST_CASE("Radial distribution", "Compare cell list RDF with all pairs")
+{
+  InputMap mcp;
+  mcp.add("cuboid_len", 40.);
+  Geometry::Cuboid geo(mcp);
+  Space spc(geo);
+  PointParticle a;
+  a.clear();
+  for (int i=0; i<1200; i++) {
+    spc.geo->randompos(a);
+    a.id = i%3;
+    spc.p.push_back(a);
+  }
+  GroupAtomic g;
+  g.setrange(0,1199);
+
+  Analysis::RadialDistribution<float,unsigned int> rdf(0.5), rdfall(0.5);
+  Analysis::Table2D<float,unsigned int> ref(0.5);
+  rdf.maxdist=10;
+  rdf.sample(spc,g,0,1);
+  rdfall.sample(spc,g,0,1);
+  for (int i=0; i<1200; i++)
+    for (int j=i+1; j<1200; j++)
+      if ((spc.p[i].id==0 && spc.p[j].id==1) || (spc.p[i].id==1 && spc.p[j].id==0))
+        ref( spc.geo->dist(spc.p[i],spc.p[j]) )++;
+
+  for (float r=0; r<=9.5; r+=0.5) {
+    CHECK( rdf(r)==ref(r) );
+    CHECK( rdfall(r)==ref(r) );
+  }
+  CHECK( rdf(25)==0 );
+  CHECK( rdfall(25)==ref(25) );
+}
+
+TEST_CASE("Debye formula", "Compare histogram Debye formula with direct summation")
+{
+  InputMap mcp;
+  mcp.add("cuboid_len", 50.);
+  mcp.add("debye_dr", 0.01);
+  Scatter::DebyeFormula<Geometry::Cuboid,Scatter::FormFactorSphere> debye(mcp);
+  Scatter::FormFactorSphere F;
+  Geometry::Cuboid geo(mcp);
+  p_vec p(100);
+  for (size_t i=0; i<p.size(); i++) {
+    geo.randompos(p[i]);
+    p[i].id = i%2;
+    p[i].radius = (i%2==0) ? 2 : 3;
+  }
+  debye.sample(p, 0.05, 0.5, 0.05);
+  double rho = p.size()/geo.getVolume();
+  for (auto &m : debye.I) {
+    float q=m.first;
+    double sum=0;
+    for (size_t i=0; i<p.size()-1; i++)
+      for (size_t j=i+1; j<p.size(); j++) {
+        double r=geo.dist(p[i],p[j]);
+        sum += F(q,p[i]) * F(q,p[j]) * sin(q*r) / (q*r);
+      }
+    CHECK( m.second.avg() == Approx(2*rho*sum).epsilon(0.01) );
+  }
+}
+
+TEST_CASE("Parallel Widom", "Compare parallel and serial Widom insertion of hard spheres")
+{
+  InputMap mcp;
+  mcp.add("cuboid_len", 30.);
+  Energy::Nonbonded<Potential::HardSphere,Geometry::Cuboid> pot(mcp);
+  Space spc( pot.getGeometry() );
+  PointParticle a;
+  a.clear();
+  a.radius=1;
+  for (int i=0; i<200; i++) {
+    spc.geo->randompos(a);
+    spc.insert(a);
+  }
+  Analysis::Widom serial(spc,pot);
+  Analysis::WidomParallel<decltype(pot)> w1(spc,pot), w2(spc,pot);
+  for (auto w : {(Analysis::Widom*)&serial, (Analysis::Widom*)&w1, (Analysis::Widom*)&w2})
+    w->addGhost(a);
+  CHECK( !w2.hardcore );
+  w1.hardcore=true;
+  serial.sample(20000);
+  slp_global.seed(5);
+  w1.sample(20000);
+  slp_global.seed(5);
+  w2.sample(20000);
+  CHECK( w1.muex()==w2.muex() ); // same random streams
+  CHECK( w1.muex()==Approx(serial.muex()).epsilon(0.1) );
+
+  // streams follow the global seed
+  Analysis::WidomParallel<decltype(pot)> w3(spc,pot);
+  w3.addGhost(a);
+  slp_global.seed(6);
+  w3.sample(20000);
+  CHECK( w3.muex()!=w1.muex() );
+
+  // soft overlap: default must not reject overlapping ghosts
+  mcp.add("lj_eps", 0.05);
+  Energy::Nonbonded<Potential::LennardJones,Geometry::Cuboid> lj(mcp);
+  Analysis::Widom ljserial(spc,lj);
+  Analysis::WidomParallel<decltype(lj)> ljpar(spc,lj);
+  ljserial.addGhost(a);
+  ljpar.addGhost(a);
+  ljserial.sample(20000);
+  ljpar.sample(20000);
+  CHECK( std::abs(ljpar.muex()-ljserial.muex()) < 0.02 );
+}
+
+TEST_CASE("Potential matrix", "Compare type matrix and map of pair potentials")
+{
+  InputMap mcp;
+  auto atoms = atom.list;                  // temporary atom types
+  for (double q : {1,-1}) {
+    AtomData d;
+    d.id = atom.list.size();
+    d.charge = q;
+    d.radius = 2;
+    atom.list.push_back(d);
+  }
+  int t1=atoms.size(), t2=t1+1;
+  Potential::PotentialMap<Potential::DebyeHuckelLJ> map(mcp);
+  Potential::PotentialMatrix<Potential::DebyeHuckelLJ,Potential::Coulomb,Potential::CosAttract> mat(mcp);
+  map.add(t1, t1, Potential::Coulomb(mcp));
+  map.add(t1, t2, Potential::CosAttract(mcp));
+  mat.add(t1, t1, Potential::Coulomb(mcp));
+  mat.add(t1, t2, Potential::CosAttract(mcp));
+
+  PointParticle a, b, c;
+  a=atom[t1];
+  b=atom[t2];
+  c=atom[0];
+  for (double r2 : {10., 25., 100.}) {
+    CHECK( mat(a,a,r2) == Approx(map(a,a,r2)) );
+    CHECK( mat(a,b,r2) == Approx(map(a,b,r2)) );
+    CHECK( mat(b,a,r2) == Approx(mat(a,b,r2)) );
+    CHECK( mat(b,b,r2) == Approx(map(b,b,r2)) );
+    CHECK( mat(a,c,r2) == Approx(map(a,c,r2)) );
+  }
+  atom.list = atoms;
+}
+
+TEST_CASE("Cell list", "Compare cell list and full nonbonded energies")
+{
+  typedef Energy::Nonbonded<Potential::CoulombWolf,Geometry::Cuboid> Tfull;
+  typedef Energy::NonbondedCellList<Potential::CoulombWolf,Geometry::Cuboid> Tcell;
+  InputMap mcp;
+  mcp.add("cuboid_len", 40.);
+  mcp.add("coulomb_cut", 10.);
+  mcp.add("celllist_cutoff", 10.);
+  Tfull full(mcp);
+  Tcell cell(mcp);
+  Space spc( full.getGeometry() );
+  cell.setSpace(spc);
+
+  PointParticle a;
+  a.clear();
+  for (int i=0; i<200; i++) {
+    spc.geo->randompos(a);
+    a.charge = (i%2==0) ? 1 : -1;
+    spc.p.push_back(a);
+    spc.trial.push_back(a);
+  }
+  Group g(10,49);
+
+  for (int i : {0,20,199})
+    CHECK( cell.i2all(spc.p,i) == Approx(full.i2all(spc.p,i)) );
+  CHECK( cell.g2all(spc.p,g) == Approx(full.g2all(spc.p,g)) );
+  CHECK( cell.g_internal(spc.p,g) == Approx(full.g_internal(spc.p,g)) );
+
+  // trial move of a single particle
+  Change moved;
+  moved.insert(20);
+  spc.trial[20].translate(*spc.geo, Point(7,-3,11));
+  cell.trialUpdate(spc, moved);
+  CHECK( cell.i2all(spc.trial,20) == Approx(full.i2all(spc.trial,20)) );
+  CHECK( cell.i2all(spc.trial,100) == Approx(full.i2all(spc.trial,100)) );
+  CHECK( cell.g2all(spc.trial,g) == Approx(full.g2all(spc.trial,g)) );
+  CHECK( cell.i2all(spc.p,20) == Approx(full.i2all(spc.p,20)) );
+
+  double du = full.i2all(spc.trial,20) - full.i2all(spc.p,20);
+  CHECK( full.i2all_change(spc.trial,spc.p,20) == Approx(du) );
+  CHECK( cell.i2all_change(spc.trial,spc.p,20) == Approx(du) );
+  CHECK( full.i_total_change(spc.trial,spc.p,20) == Approx(du) );
+
+  spc.p[20] = spc.trial[20];
+  cell.acceptUpdate(moved);
+  CHECK( cell.i2all(spc.p,20) == Approx(full.i2all(spc.p,20)) );
+  CHECK( cell.g_internal(spc.p,g) == Approx(full.g_internal(spc.p,g)) );
+}
+
+TEST_CASE("Particle arrays", "Compare structure-of-arrays and nonbonded energies")
+{
+  typedef Potential::CombinedPairPotential<Potential::DebyeHuckel,Potential::LennardJones> Tpairpot;
+  InputMap mcp;
+  mcp.add("cuboid_len", 30.);
+  mcp.add("dh_ionicstrength", 0.05);
+  mcp.add("lj_eps", 0.1);
+  Energy::Nonbonded<Tpairpot,Geometry::Cuboid> full(mcp);
+  Energy::NonbondedArrays<Tpairpot,Geometry::Cuboid> soa(mcp);
+  Space spc( full.getGeometry() );
+
+  PointParticle a;
+  a.clear();
+  a.radius=1.5;
+  for (int i=0; i<100; i++) {
+    spc.geo->randompos(a);
+    a.charge = (i%2==0) ? 1 : -1;
+    spc.insert(a);
+  }
+  soa.setSpace(spc);
+  Group g1(0,19), g2(40,59);
+
+  CHECK( soa.i2all(spc.p,5) == Approx(full.i2all(spc.p,5)) );
+  CHECK( soa.i2g(spc.p,g1,5) == Approx(full.i2g(spc.p,g1,5)) );
+  CHECK( soa.g2g(spc.p,g1,g2) == Approx(full.g2g(spc.p,g1,g2)) );
+  CHECK( soa.g2all(spc.p,g1) == Approx(full.g2all(spc.p,g1)) );
+  CHECK( soa.g_internal(spc.p,g2) == Approx(full.g_internal(spc.p,g2)) );
+
+  spc.trial[5].translate(*spc.geo, Point(8,-4,2));
+  spc.syncArrays(5);
+  CHECK( soa.i2all(spc.trial,5) == Approx(full.i2all(spc.trial,5)) );
+  g1.accept(spc);
+  CHECK( spc.p_arr.x[5] == Approx(spc.trial[5].x()) );
+  CHECK( soa.g2all(spc.p,g1) == Approx(full.g2all(spc.p,g1)) );
+}
+
+TEST_CASE("Group cache", "Compare cached and calculated group-group energies")
+{
+  InputMap mcp;
+  mcp.add("cuboid_len", 40.);
+  mcp.add("dh_ionicstrength", 0.05);
+  mcp.add("transrot_transdp", 10.);
+  mcp.add("mv_particle_genericdp", 10.);
+  Energy::Hamiltonian pot;
+  auto nb = pot.create( Energy::Nonbonded<Potential::DebyeHuckel,Geometry::Cuboid>(mcp) );
+  Space spc( pot.getGeometry() );
+
+  PointParticle a;
+  a.clear();
+  vector<GroupMolecular> mol(4);
+  for (auto &g : mol) {
+    p_vec v;
+    Point cm;
+    spc.geo->randompos(cm);
+    for (int i=0; i<5; i++) {
+      a = cm + Point(i,0,i%2);
+      spc.geo->boundary(a);
+      a.charge = (i%2==0) ? 1 : -1;
+      v.push_back(a);
+    }
+    g = spc.insert(v);
+    g.name="molecule";
+    g.setMassCenter(spc);
+    spc.enroll(g);
+  }
+  GroupAtomic salt;
+  salt.name="salt";
+  for (int i=0; i<10; i++) {
+    spc.geo->randompos(a);
+    a.charge = (i%2==0) ? 1 : -1;
+    spc.insert(a);
+  }
+  salt.setrange(20,29);
+  spc.enroll(salt);
+
+  pot.enableGroupCache(spc);
+  Move::TranslateRotate gmv(mcp,pot,spc);
+  Move::AtomicTranslation mv(mcp,pot,spc);
+  double u0 = Energy::systemEnergy(spc,*nb,spc.p);
+  CHECK( Energy::systemEnergy(spc,pot,spc.p) == Approx(u0) );
+  std::stringstream state;
+  spc.save(state);
+
+  double du=0;
+  for (int n=0; n<20; n++) {
+    gmv.setGroup( mol[n%4] );
+    du += gmv.move();
+    if (n%5==0) {
+      mv.setGroup(salt);
+      du += mv.move();
+    }
+  }
+  double u1 = Energy::systemEnergy(spc,*nb,spc.p);
+  CHECK( Energy::systemEnergy(spc,pot,spc.p) == Approx(u1) );
+  CHECK( du == Approx(u1-u0) );
+  CHECK( pot.groupCache()->g2g(mol[0],salt) == Approx(nb->g2g(spc.p,mol[0],salt)) );
+
+  // loading a different configuration must invalidate the cache
+  CHECK( spc.load(state) );
+  CHECK( u0 != Approx(u1) );
+  CHECK( Energy::systemEnergy(spc,pot,spc.p) == Approx(u0) );
+  CHECK( pot.groupCache()->g2g(mol[0],salt) == Approx(nb->g2g(spc.p,mol[0],salt)) );
+}
+
+TEST_CASE("Bonds", "Check bond energies and index shifts")
+{
+  InputMap mcp;
+  mcp.add("cuboid_len", 100.);
+  Geometry::Cuboid geo(mcp);
+  Energy::Bonded b(geo);
+  Potential::Harmonic harm(0.5, 4.0);
+  Potential::FENE fene(0.2, 10.0);
+  auto gen = Potential::Harmonic(0.1, 2.0) + Potential::Harmonic(0.3, 1.0); // generic bond
+  p_vec p(10);
+  for (size_t i=0; i<p.size(); i++) {
+    p[i].clear();
+    p[i].x()=3.5*i;
+    p[i].radius=1.5;
+  }
+  for (int i=0; i<9; i++)
+    b.add(i, i+1, harm);
+  b.add(0, 2, fene);
+  b.add(5, 8, gen);
+
+  double u=0;
+  for (int i=0; i<9; i++)
+    u+=harm(p[i],p[i+1],geo.sqdist(p[i],p[i+1]));
+  double ufene=fene(p[0],p[2],geo.sqdist(p[0],p[2]));
+  double ugen=gen(p[5],p[8],geo.sqdist(p[5],p[8]));
+  u+=ufene+ugen;
+
+  Group g(0,9), g1(0,4), g2(5,9);
+  CHECK( b.size()==11 );
+  CHECK( b.total(p) == Approx(u) );
+  CHECK( b.g_internal(p,g) == Approx(u) );
+  CHECK( b.i2i(p,2,0) == Approx(ufene) );
+  CHECK( b.i2i(p,3,0) == 0 );
+  CHECK( b.i2all(p,8) == Approx( ugen+harm(p[7],p[8],geo.sqdist(p[7],p[8]))
+        +harm(p[8],p[9],geo.sqdist(p[8],p[9])) ) );
+  double u12=b.g_internal(p,g1)+b.g_internal(p,g2);
+  CHECK( u12 == Approx( u-harm(p[4],p[5],geo.sqdist(p[4],p[5])) ) );
+  b.CrossGroupBonds=true;
+  CHECK( b.g2g(p,g1,g2) == Approx( harm(p[4],p[5],geo.sqdist(p[4],p[5])) ) );
+
+  // insert two particles in front and remove one at the end
+  p.insert(p.begin(), 2, p[9]);
+  b.insert(0,2);
+  CHECK( b.total(p) == Approx(u) );
+  CHECK( b.i2i(p,4,2) == Approx(ufene) );
+  p.erase(p.begin()+11);
+  b.erase(11);
+  CHECK( b.size()==10 );
+  CHECK( b.total(p) == Approx(u-harm(p[0],p[0],3.5*3.5)) );
+
+  // adding an existing pair replaces the bond and unused potentials are removed
+  Energy::Bonded c(geo);
+  c.add(0, 1, harm);
+  c.add(1, 2, gen);
+  Potential::Harmonic harm2(0.2, 3.0);
+  c.add(2, 1, harm2);
+  CHECK( c.size()==2 );
+  CHECK( c.i2i(p,1,2) == Approx( harm2(p[1],p[2],geo.sqdist(p[1],p[2])) ) );
+  string s=c.info();
+  int ngeneric=-1;
+  std::istringstream( s.substr( s.find("Generic (slow) bonds:")+21 ) ) >> ngeneric;
+  CHECK( ngeneric==0 );
+  c.erase(0);
+  CHECK( c.size()==1 );
+  CHECK( c.total(p) == Approx( harm2(p[0],p[1],geo.sqdist(p[0],p[1])) ) );
+}
+
+TEST_CASE("Atom tracker", "Track species while inserting and erasing particles")
+{
+  InputMap mcp;
+  mcp.add("cuboid_len", 30.);
+  Geometry::Cuboid geo(mcp);
+  Space spc(geo);
+  PointParticle a;
+  a.clear();
+  GroupAtomic other, salt;
+  for (int i=0; i<5; i++)
+    spc.insert(a);
+  other.setrange(0,4);
+  for (int i=0; i<20; i++) {
+    a.id = 1 + i%2;
+    spc.insert(a);
+  }
+  salt.setrange(5,24);
+  spc.enroll(other);
+  spc.enroll(salt);
+
+  Move::AtomTracker track(spc);
+  for (auto i : salt)
+    track.add(i);
+  for (int n=0; n<200; n++) {
+    if (slp_global()>0.5) {
+      a.id = 1 + n%2;
+      track.insert(a, salt.back());
+    } else if (!track[2].empty())
+      track.erase( track[2].random(), salt );
+    int cnt=0;
+    for (particle::Tid id : {1,2})
+      for (auto i : track[id]) {
+        CHECK( spc.p[i].id==id );
+        CHECK( salt.find(i) );
+        cnt++;
+      }
+    CHECK( cnt==salt.size() );
+  }
+  CHECK( other.size()==5 );
+}
+
+/* Hard spheres that count pair evaluations */
+struct CountingHardSphere : public Potential::HardSphere {
+  unsigned long cnt;
+  CountingHardSphere(InputMap &in) : Potential::HardSphere(in), cnt(0) {}
+  template<class Tparticle>
+    double operator()(const Tparticle &a, const Tparticle &b, double r2) {
+      cnt++;
+      return Potential::HardSphere::operator()(a,b,r2);
+    }
+};
+
+TEST_CASE("Early rejection", "Hard sphere moves rejected at infinite energy")
+{
+  InputMap mcp;
+  mcp.add("cuboid_len", 20.);
+  mcp.add("mv_particle_genericdp", 4.);
+  Energy::Hamiltonian pot;
+  pot.create( Energy::Nonbonded<Potential::HardSphere,Geometry::Cuboid>(mcp) );
+  Space spc( pot.getGeometry() );
+  PointParticle a;
+  a.clear();
+  a.radius=1.5;
+  GroupAtomic g;
+  for (int i=0; i<4; i++)        // simple cubic lattice, no overlap
+    for (int j=0; j<4; j++)
+      for (int k=0; k<4; k++) {
+        a.x()=-7.5+5*i;
+        a.y()=-7.5+5*j;
+        a.z()=-7.5+5*k;
+        spc.insert(a);
+      }
+  g.setrange(0,63);
+  spc.enroll(g);
+  Move::AtomicTranslation mv(mcp,pot,spc);
+  mv.setGroup(g);
+  double du=mv.move(1000);
+  CHECK( du==0 );
+  CHECK( mv.getAcceptance()>0 );
+  CHECK( mv.getAcceptance()<1 );
+  int overlaps=0;
+  for (int i=0; i<63; i++)
+    for (int j=i+1; j<64; j++)
+      if ( spc.geo->sqdist(spc.p[i],spc.p[j]) < 9 )
+        overlaps++;
+  CHECK( overlaps==0 );
+  CHECK( mv.info().find("Early rejection") != string::npos );
+
+  // pair loops stop at the first overlap: three parallel rods where the
+  // middle one is moved sideways and overlaps unless |dy|<0.1
+  InputMap in;
+  in.add("cuboid_len", 100.);
+  in.add("transrot_transdp", 4.);
+  in.add("transrot_rotdp", 0.);
+  Energy::Hamiltonian ham;
+  auto hs = ham.create( Energy::Nonbonded<CountingHardSphere,Geometry::Cuboid>(in) );
+  Space rods( ham.getGeometry() );
+  a.radius=0.95;
+  vector<GroupMolecular> g3(3);
+  for (int k=0; k<3; k++) {
+    p_vec rod(20, a);
+    for (int i=0; i<20; i++) {
+      rod[i].x()=-19+2*i;
+      rod[i].y()=-2+2*k;
+      rod[i].z()=0;
+    }
+    g3[k] = rods.insert(rod);
+    g3[k].name="rod";
+  }
+  for (auto &g : g3)
+    rods.enroll(g);
+  Move::TranslateRotate tr(in, ham, rods);
+  tr.directions["rod"]=Point(0,1,0);
+  tr.setGroup(g3[1]);
+  int nmoves=100;
+  hs->pairpot.cnt=0;
+  tr.move(nmoves);
+  unsigned long full = nmoves*2*(20*20*2); // new and old energy with both rods
+  CHECK( hs->pairpot.cnt < full/2 );
+  CHECK( tr.getAcceptance() < 0.2 );
+}
+
+/* Debye-Huckel with a (plain Coulomb) field to check field() summation */
+struct DebyeHuckelField : public Potential::DebyeHuckel {
+  DebyeHuckelField(InputMap &in) : Potential::DebyeHuckel(in) {}
+  Point field(const particle &a, const Point &r) const {
+    return a.charge * r / std::pow(r.norm(),3);
+  }
+};
+
+TEST_CASE("Static Hamiltonian", "Compare compile-time and run-time Hamiltonians")
+{
+  typedef DebyeHuckelField Tpairpot;
+  InputMap mcp;
+  mcp.add("cuboid_len", 40.);
+  mcp.add("dh_ionicstrength", 0.05);
+  Energy::Hamiltonian pot;
+  auto nb = pot.create( Energy::Nonbonded<Tpairpot,Geometry::Cuboid>(mcp) );
+  auto bonded = pot.create( Energy::Bonded() );
+  pot.create( Energy::ExternalPressure(pot.getGeometry(), 1e-4) );
+
+  Energy::StaticHamiltonian<Tpairpot,Geometry::Cuboid,Energy::Bonded,Energy::ExternalPressure>
+    spot(mcp, Energy::Bonded(), Energy::ExternalPressure(pot.getGeometry(), 1e-4));
+
+  Space spc( pot.getGeometry() );
+  PointParticle a;
+  a.clear();
+  for (int i=0; i<30; i++) {
+    spc.geo->randompos(a);
+    a.charge = (i%2==0) ? 1 : -1;
+    spc.insert(a);
+  }
+  GroupAtomic g1, g2;
+  g1.setrange(0,9);
+  g2.setrange(10,29);
+  spc.enroll(g1);
+  spc.enroll(g2);
+  for (int i=0; i<9; i++) {
+    bonded->add(i, i+1, Potential::Harmonic(0.1,4.0));
+    spot.term<0>().add(i, i+1, Potential::Harmonic(0.1,4.0));
+  }
+  for (auto i : g1)
+    spc.trial[i].translate( *spc.geo, Point(1,0.5,0) );
+
+  CHECK( spot.term<1>().name == "External Pressure" );
+  CHECK( spot.info().find("Bonded particles") != string::npos );
+  CHECK( spot.i2all(spc.p,3) == Approx(pot.i2all(spc.p,3)) );
+  CHECK( spot.i_total_change(spc.trial,spc.p,3) == Approx(pot.i_total_change(spc.trial,spc.p,3)) );
+  CHECK( spot.g2g(spc.p,g1,g2) == Approx(pot.g2g(spc.p,g1,g2)) );
+  CHECK( spot.g_internal(spc.p,g1) == Approx(pot.g_internal(spc.p,g1)) );
+  CHECK( spot.g_external(spc.p,g2) == Approx(pot.g_external(spc.p,g2)) );
+  CHECK( spot.external() == Approx(pot.external()) );
+  CHECK( Energy::systemEnergy(spc,spot,spc.p) == Approx(Energy::systemEnergy(spc,pot,spc.p)) );
+
+  std::vector<Point> E1(spc.p.size(), Point(0,0,0)), E2=E1;
+  pot.field(spc.p, E1);
+  spot.field(spc.p, E2);
+  CHECK( E1[3].norm()>0 );
+  for (size_t i=0; i<E1.size(); i++)
+    CHECK( (E1[i]-E2[i]).norm() == Approx(0) );
+}
+
+TEST_CASE("Checkpoint", "Save and restore binary simulation state")
+{
+  InputMap mcp;
+  mcp.add("cuboid_len", 30.);
+  mcp.add("dh_ionicstrength", 0.05);
+  mcp.add("mv_particle_genericdp", 5.);
+  mcp.add("loop_macrosteps", 4);
+  mcp.add("loop_microsteps", 2);
+  mcp.add("loop_checkpoint", 2);
+  Energy::Nonbonded<Potential::DebyeHuckel,Geometry::Cuboid> pot(mcp);
+  Space spc( pot.getGeometry() );
+
+  PointParticle a;
+  a.clear();
+  GroupAtomic salt;
+  salt.name="salt";
+  for (int i=0; i<20; i++) {
+    spc.geo->randompos(a);
+    a.charge = (i%2==0) ? 1 : -1;
+    spc.insert(a);
+  }
+  salt.setrange(0,19);
+  spc.enroll(salt);
+  Move::AtomicTranslation mv(mcp,pot,spc);
+  mv.setGroup(salt);
+
+  MCLoop loop(mcp);
+  Checkpoint cp("unittest_checkpoint.bin");
+  cp.add("space", spc);
+  cp.add("rng", slp_global);
+  cp.add("translate", mv);
+  loop.setCheckpoint(cp);
+  while ( loop.macroCnt() )
+    while ( loop.microCnt() )
+      mv.move();
+  // last checkpoint was saved after macrostep 4
+  p_vec p=spc.p;
+  double acc=mv.getAcceptance(), x=slp_global();
+
+  for (int i=0; i<10; i++)
+    mv.move();
+  spc.p[0].charge=10;
+  spc.geo->setVolume(2e4);
+
+  CHECK( cp.load() );
+  CHECK( spc.geo->getVolume() == Approx(27e3) );
+  CHECK( spc.p.size()==p.size() );
+  CHECK( spc.p[0].charge==p[0].charge );
+  CHECK( spc.p[7].x()==p[7].x() );
+  CHECK( spc.trial[7].z()==p[7].z() );
+  CHECK( mv.getAcceptance()==acc );
+  CHECK( slp_global()==x );
+  CHECK( loop.macroCnt()==false ); // restored loop is complete
+
+  // loading is all or nothing
+  spc.p[0].charge=10;
+  spc.geo->setVolume(2e4);
+  Checkpoint cp2("unittest_checkpoint.bin");
+  cp2.add("space", spc);
+  cp2.add("translate", [](std::ostream&) {}, [](std::istream&) { return false; });
+  CHECK( !cp2.load() );
+  CHECK( spc.p[0].charge==10 );
+  CHECK( spc.geo->getVolume() == Approx(2e4) );
+  Checkpoint cp3("unittest_checkpoint.bin");
+  cp3.add("space", spc);
+  cp3.add("missing", [](std::ostream&) {}, [](std::istream&) { return true; });
+  CHECK( !cp3.load() );
+  CHECK( spc.p[0].charge==10 );
+
+  GroupAtomic extra;
+  extra.setrange(0,1);
+  spc.enroll(extra); // group count no longer matches the file
+  CHECK( !cp.load() );
+  CHECK( spc.p[0].charge==10 );
+  std::remove("unittest_checkpoint.bin");
+}
+
+TEST_CASE("XTC trajectory", "Write frames in background and read them back")
+{
+  InputMap mcp;
+  mcp.add("cuboid_len", 30.);
+  Geometry::Cuboid geo(mcp);
+  Space spc(geo);
+  PointParticle a;
+  a.clear();
+  for (int i=0; i<50; i++) {
+    spc.geo->randompos(a);
+    spc.insert(a);
+  }
+  vector<p_vec> frames;
+  FormatXTC xtc(30, 2);
+  for (int n=0; n<5; n++) {
+    for (auto &i : spc.p)
+      i.translate(*spc.geo, Point(1,-2,0.5));
+    frames.push_back(spc.p);
+    CHECK( xtc.save("unittest.xtc", spc) );
+  }
+  xtc.close();
+
+  CHECK( xtc.open("unittest.xtc") );
+  for (int n=0; n<5; n++) {
+    CHECK( xtc.loadnextframe(spc) );
+    auto &p = frames[n];
+    for (int i : {0,25,49})
+      CHECK( spc.geo->sqdist(spc.p[i], p[i]) < 1e-3 );
+  }
+  xtc.close();
+  std::remove("unittest.xtc");
+}
+
+TEST_CASE("Ewald", "Check Ewald summation and incremental updates")
+{
+  typedef Energy::NonbondedEwald<Potential::CoulombEwald,Geometry::Cuboid> Tewald;
+  InputMap mcp;
+  mcp.add("cuboid_len", 100.);
+  mcp.add("ewald_alpha", 0.1);
+  mcp.add("ewald_cutoff", 40.);
+  mcp.add("ewald_kmax", 10);
+  Tewald ewald(mcp);
+  Space spc( ewald.getGeometry() );
+
+  // ion pair in big box approaches plain Coulomb
+  PointParticle a;
+  a.clear();
+  a.charge=1;
+  spc.insert(a);
+  a.charge=-1;
+  a.x()=5;
+  spc.insert(a);
+  ewald.setSpace(spc);
+  double lB = Potential::Coulomb(mcp).bjerrumLength();
+  double u = ewald.all2all(spc.p) + ewald.external();
+  CHECK( u == Approx(-lB/5).epsilon(0.01) );
+  CHECK( ewald.i2all(spc.p,0) == Approx(ewald.all2all(spc.p)) );
+
+  // random salt in rectangular box
+  mcp.add("cuboid_xlen", 20.);
+  mcp.add("cuboid_ylen", 25.);
+  mcp.add("cuboid_zlen", 30.);
+  mcp.add("cuboid_len", -1.);
+  mcp.add("ewald_alpha", 0.3);
+  mcp.add("ewald_cutoff", 10.);
+  mcp.add("ewald_kmax", 6);
+  Tewald ew2(mcp);
+  Space spc2( ew2.getGeometry() );
+  for (int i=0; i<40; i++) {
+    spc2.geo->randompos(a);
+    a.charge = (i%2==0) ? 1 : -1;
+    spc2.insert(a);
+  }
+  ew2.setSpace(spc2);
+  double u0 = ew2.all2all(spc2.p);
+
+  Change moved;
+  moved.insert(7);
+  spc2.trial[7].translate(*spc2.geo, Point(3,-2,4));
+  ew2.trialUpdate(spc2, moved);
+  double du = ew2.i2all(spc2.trial,7) - ew2.i2all(spc2.p,7);
+  double u1 = ew2.all2all(spc2.trial);
+  CHECK( du == Approx(u1-u0) );
+  spc2.p[7]=spc2.trial[7];
+  ew2.acceptUpdate(moved);
+  CHECK( ew2.all2all(spc2.p) == Approx(u1) );
+
+  Group g(10,19);
+  spc2.trial[12].translate(*spc2.geo, Point(-5,1,1));
+  moved.clear();
+  moved.insert(12);
+  ew2.trialUpdate(spc2, moved);
+  du = ew2.g2all(spc2.trial,g) - ew2.g2all(spc2.p,g)
+    + ew2.g_internal(spc2.trial,g) - ew2.g_internal(spc2.p,g);
+  CHECK( du == Approx(ew2.all2all(spc2.trial)-u1) );
+  spc2.trial[12]=spc2.p[12];
+  ew2.rejectUpdate(moved);
+  CHECK( ew2.all2all(spc2.p) == Approx(u1) );
+}
+
+TEST_CASE("SPME", "Check particle-mesh Ewald against Ewald summation")
+{
+  // FFT against direct summation
+  FFT3D fft;
+  fft.resize(4,8,2);
+  FFT3D::Tvec v( fft.size() ), ref( fft.size() );
+  for (auto &i : v)
+    i = FFT3D::Tcomplex( slp_global(), slp_global() );
+  for (int k=0; k<fft.size(); k++)
+    for (int j=0; j<fft.size(); j++) {
+      double arg = 2*pc::pi*( (k%4)*(j%4)/4. + (k/4%8)*(j/4%8)/8. + (k/32)*(j/32)/2. );
+      ref[k] += v[j]*std::polar(1.0,-arg);
+    }
+  FFT3D::Tvec w=v;
+  fft.forward(w);
+  CHECK( std::abs(w[5]-ref[5]) == Approx(0) );
+  CHECK( std::abs(w[37]-ref[37]) == Approx(0) );
+  fft.backward(w);
+  CHECK( std::abs(w[11]/double(fft.size())-v[11]) == Approx(0) );
+
+  // random salt in rectangular box
+  typedef Energy::NonbondedEwald<Potential::CoulombEwald,Geometry::Cuboid> Tewald;
+  typedef Energy::NonbondedSPME<Potential::CoulombEwald,Geometry::Cuboid> Tspme;
+  InputMap mcp;
+  mcp.add("cuboid_xlen", 20.);
+  mcp.add("cuboid_ylen", 25.);
+  mcp.add("cuboid_zlen", 30.);
+  mcp.add("ewald_alpha", 0.3);
+  mcp.add("ewald_cutoff", 10.);
+  mcp.add("ewald_kmax", 8);
+  mcp.add("spme_mesh", 32);
+  mcp.add("spme_order", 6);
+  mcp.add("spme_maxpending", 1000);
+  Tewald ewald(mcp);
+  Tspme spme(mcp);
+  Space spc( spme.getGeometry() );
+  PointParticle a;
+  a.clear();
+  for (int i=0; i<40; i++) {
+    spc.geo->randompos(a);
+    a.charge = (i%2==0) ? 1 : -1;
+    spc.insert(a);
+  }
+  spme.setSpace(spc);
+  ewald.setSpace(spc);
+  Group all(0,spc.p.size()-1);
+  double uewald = ewald.all2all(spc.p) + ewald.external();
+  double u0 = spme.all2all(spc.p) + spme.g_external(spc.p,all);
+  CHECK( u0 == Approx(uewald).epsilon(1e-3) );
+
+  // local mesh updates, including pending changes and refreshes
+  Change moved;
+  for (int n=0; n<6; n++) {
+    int i=(7*n)%40;
+    moved.clear();
+    moved.insert(i);
+    spc.trial[i].translate(*spc.geo, Point(3,-2,4));
+    spme.trialUpdate(spc, moved);
+    double du = spme.i2all(spc.trial,i) + spme.i_external(spc.trial,i)
+      - spme.i2all(spc.p,i) - spme.i_external(spc.p,i);
+    double u1 = spme.all2all(spc.trial) + spme.g_external(spc.trial,all);
+    CHECK( du == Approx(u1-u0) );
+    if (n%3==2) {
+      spc.trial[i]=spc.p[i];
+      spme.rejectUpdate(moved);
+    } else {
+      spc.p[i]=spc.trial[i];
+      spme.acceptUpdate(moved);
+      u0=u1;
+    }
+    double u2 = spme.all2all(spc.p) + spme.g_external(spc.p,all);
+    CHECK( u2 == Approx(u0) );
+  }
+
+  // group energy terms sum up to total energy
+  Group first(0,9), g(10,19), rest(20,39);
+  double usum = spme.g2all(spc.p,g) + spme.g_internal(spc.p,g)
+    + spme.g_internal(spc.p,rest) + spme.g2g(spc.p,rest,first) + spme.g_internal(spc.p,first);
+  CHECK( usum == Approx(spme.all2all(spc.p)) );
+
+  // reciprocal space fields are not available
+  std::vector<Point> E(spc.p.size(), Point(0,0,0));
+  CHECK_THROWS( ewald.field(spc.p,E) );
+  CHECK_THROWS( spme.field(spc.p,E) );
+}
+
+struct ScaledWell : public Energy::Energybase {
+  double scale;
+  ScaledWell() : scale(1) {}
+  double i_external(const p_vec &p, int i) FOVERRIDE { return scale*p[i].x()*p[i].x(); }
+  double g_external(const p_vec &p, Group &g) FOVERRIDE {
+    double u=0;
+    for (auto i : g)
+      u+=i_external(p,i);
+    return u;
+  }
+  string _info() { return "scaled well"; }
+};
+
+TEST_CASE("Replica exchange", "Exchange states between replicas in one process")
+{
+  InputMap mcp;
+  mcp.add("cuboid_len", 10.);
+  Geometry::Cuboid geo(mcp);
+  vector<double> T = {1.0, 1.5, 2.0};
+  vector<ScaledWell> pot(3);
+  Space s0(geo), s1(geo), s2(geo);
+  vector<Space*> spc = {&s0, &s1, &s2};
+  Group g(0,0);
+  PointParticle a;
+  a.clear();
+  a.x()=2;
+#ifdef ENABLE_MPI
+  Move::ReplicaExchange rex(mcp, nullptr);
+#else
+  Move::ReplicaExchange rex(mcp);
+#endif
+  rex.setState = [&](Energy::Energybase &e, int k) { static_cast<ScaledWell&>(e).scale=1/T[k]; };
+  for (int i=0; i<3; i++) {
+    spc[i]->insert(a);
+    spc[i]->enroll(g);
+    rex.add(*spc[i], pot[i]);
+  }
+
+  // identical configurations - all swaps are accepted
+  rex.exchange();
+  CHECK( rex.state(0)==1 );
+  CHECK( rex.state(1)==0 );
+  CHECK( rex.state(2)==2 );
+  rex.exchange();
+  CHECK( rex.state(0)==2 );
+  CHECK( rex.state(2)==1 );
+  CHECK( pot[0].scale == Approx(1/T[2]) );
+
+  // cold replica far from minimum moves to higher temperature
+  s1.p[0].x()=s1.trial[0].x()=4;
+  s0.p[0].x()=s0.trial[0].x()=s2.p[0].x()=s2.trial[0].x()=0;
+  rex.exchange();
+  CHECK( rex.state(1)==1 );
+  CHECK( rex.state(2)==0 );
+}
+
+TEST_CASE("Isobaric powers", "Predict volume move energies from inverse power components")
+{
+  typedef Potential::CoulombLJ Tpairpot;
+  InputMap mcp;
+  mcp.add("cuboid_len", 30.);
+  mcp.add("lj_eps", 0.2);
+  mcp.add("npt_dV", 0.05);
+  mcp.add("npt_P", 100.);
+  mcp.add("npt_powers", true);
+  mcp.add("npt_validate", true);
+  Energy::Hamiltonian pot;
+  auto nb = pot.create( Energy::Nonbonded<Tpairpot,Geometry::Cuboid>(mcp) );
+  Space spc( pot.getGeometry() );
+  PointParticle a;
+  a.clear();
+  a.radius=2;
+  for (int i=0; i<27; i++) {     // simple cubic lattice of ions
+    a.x()=-10+10*(i%3);
+    a.y()=-10+10*(i/3%3);
+    a.z()=-10+10*(i/9);
+    a.charge = (i%2==0) ? 1 : -1;
+    spc.insert(a);
+  }
+  GroupAtomic g1, g2;
+  g1.setrange(0,12);
+  g2.setrange(13,26);
+  spc.enroll(g1);
+  spc.enroll(g2);
+
+  std::map<int,double> m;
+  CHECK( pot.all2all_powers(spc.p, m) );
+  CHECK( m.size()==3 );
+  double usum = m[1]+m[6]+m[12];
+  CHECK( usum == Approx(nb->all2all(spc.p)) );
+
+  Move::Isobaric mv(mcp, pot, spc);
+  double u0 = Energy::systemEnergy(spc,pot,spc.p);
+  double du = mv.move(200);
+  double drift = Energy::systemEnergy(spc,pot,spc.p) - u0;
+  CHECK( mv.getAcceptance()>0 );
+  CHECK( drift == Approx(du) );
+  CHECK( mv.info().find("Predicted energy changes") != string::npos );
+
+  // bonds cannot be decomposed - fall back to full evaluation
+  auto bonded = pot.create( Energy::Bonded() );
+  bonded->add(0, 1, Potential::Harmonic(0.1,10.0));
+  m.clear();
+  CHECK( !pot.all2all_powers(spc.p, m) );
+  u0 = Energy::systemEnergy(spc,pot,spc.p);
+  du = mv.move(50);
+  drift = Energy::systemEnergy(spc,pot,spc.p) - u0;
+  CHECK( drift == Approx(du) );
+}
+
+struct ChangeRecorder : public Energy::Energybase {
+  Change trial, accepted;
+  int cntreject;
+  ChangeRecorder() : cntreject(0) {}
+  void trialUpdate(const Space&, const Change &c) FOVERRIDE { trial=c; }
+  void acceptUpdate(const Change &c) FOVERRIDE { accepted=c; }
+  void rejectUpdate(const Change&) FOVERRIDE { cntreject++; }
+  string _info() { return "change recorder"; }
+};
+
+TEST_CASE("Change set", "Moves report changes to energy terms and Space")
+{
+  InputMap mcp;
+  mcp.add("cuboid_len", 20.);
+  mcp.add("npt_dV", 0.01);
+  mcp.add("mv_particle_genericdp", 1.);
+  Energy::Hamiltonian pot;
+  pot.create( Energy::Nonbonded<Potential::HardSphere,Geometry::Cuboid>(mcp) );
+  auto rec = pot.create( ChangeRecorder() );
+  Space spc( pot.getGeometry() );
+  PointParticle a;
+  a.clear();
+  a.radius=0.5;
+  for (int i=0; i<10; i++) {
+    a.x()=-9+2*i;
+    spc.insert(a);
+  }
+  GroupAtomic g;
+  g.setrange(0,9);
+  spc.enroll(g);
+
+  Move::AtomicTranslation mv(mcp,pot,spc);
+  mv.setGroup(g);
+  mv.move();
+  CHECK( rec->trial.index.size()==1 );
+  CHECK( g.find(*rec->trial.index.begin()) );
+  CHECK( !rec->trial.all() );
+  CHECK( rec->accepted.index==rec->trial.index );
+
+  Move::Isobaric npt(mcp,pot,spc);
+  npt.move();
+  CHECK( rec->trial.volume );
+  CHECK( rec->trial.all() );
+  CHECK( rec->trial.groups.count(&g)==1 );
+
+  // only changed slots are copied
+  Change c;
+  c.insert(2);
+  spc.trial[2].x()+=0.1;
+  spc.trial[3].x()+=0.1;
+  spc.accept(c);
+  CHECK( spc.p[2].x()==spc.trial[2].x() );
+  CHECK( spc.p[3].x()!=spc.trial[3].x() );
+  c.insert(3);
+  spc.undo(c);
+  CHECK( spc.trial[3].x()==spc.p[3].x() );
+  CHECK( spc.trial[2].x()==spc.p[2].x() );
+}
+
+/* Charged chain with harmonic bonds and salt, shared by the polymer move tests */
+struct PolymerSystem {
+  InputMap mcp;
+  Energy::Hamiltonian pot;
+  shared_ptr<Energy::Bonded> bonded;
+  Space spc;
+  GroupAtomic salt;
+  GroupMolecular pol;
+
+  /* box must exceed twice the chain extent for rigid rotations under minimum image */
+  Geometry::Geometrybase& init() {
+    mcp.add("cuboid_len", 200.);
+    mcp.add("dh_ionicstrength", 0.02);
+    pot.create( Energy::Nonbonded<Potential::DebyeHuckel,Geometry::Cuboid>(mcp) );
+    bonded = pot.create( Energy::Bonded() );
+    return pot.getGeometry();
+  }
+
+  /* salt is inserted first so that the chain does not start at index 0 */
+  PolymerSystem(int n) : spc( init() ) {
+    PointParticle a;
+    a.clear();
+    a.charge=-1;
+    salt.setrange(0,9);
+    for (int i=0; i<10; i++) {
+      spc.geo->randompos(a);
+      spc.insert(a);
+    }
+    spc.enroll(salt);
+    p_vec chain(n);
+    for (int i=0; i<n; i++) {
+      chain[i].clear();
+      chain[i].x()=-n+2*i;
+      chain[i].y()=std::sin(0.5*i);
+      chain[i].charge = (i%3==0) ? 1 : 0;
+      chain[i].mw = 10;
+    }
+    pol = spc.insert(chain);
+    spc.enroll(pol);
+    for (int i=pol.front(); i<pol.back(); i++)
+      bonded->add(i, i+1, Potential::Harmonic(0.5,2.0));
+  }
+
+  vector<double> bondlengths() const {
+    vector<double> b;
+    for (int i=pol.front(); i<pol.back(); i++)
+      b.push_back( spc.geo->dist(spc.p[i], spc.p[i+1]) );
+    return b;
+  }
+};
+
+TEST_CASE("Polymer rotations", "Crankshaft and pivot energies from rotated particles only")
+{
+  PolymerSystem s(30);
+  s.mcp.add("crank_maxlen", 6);
+  s.mcp.add("pivot_maxlen", 30);
+  Move::CrankShaft crank(s.mcp, s.pot, s.spc);
+  Move::Pivot pivot(s.mcp, s.pot, s.spc);
+  crank.setGroup(s.pol);
+  pivot.setGroup(s.pol);
+  vector<double> b0 = s.bondlengths();
+  double u0 = Energy::systemEnergy(s.spc,s.pot,s.spc.p);
+  double du = crank.move(200) + pivot.move(200);
+  double drift = Energy::systemEnergy(s.spc,s.pot,s.spc.p) - u0;
+  CHECK( crank.getAcceptance()>0 );
+  CHECK( pivot.getAcceptance()>0 );
+  CHECK( drift == Approx(du) );
+
+  // rigid rotations keep all bond lengths
+  vector<double> b = s.bondlengths();
+  for (size_t i=0; i<b.size(); i++)
+    CHECK( b[i] == Approx(b0[i]) );
+}
+
+TEST_CASE("Polymer regrowth", "Configurational-bias regrowth of chain ends and interior monomers")
+{
+  PolymerSystem s(20);
+  s.mcp.add("cbmc_maxlen", 5);
+  Move::Regrowth cb(s.mcp, s.pot, s.spc);
+  cb.setGroup(s.pol);
+  vector<double> b0 = s.bondlengths();
+  double u0 = Energy::systemEnergy(s.spc,s.pot,s.spc.p);
+  double du = cb.move(200);
+  double drift = Energy::systemEnergy(s.spc,s.pot,s.spc.p) - u0;
+  CHECK( cb.getAcceptance()>0 );
+  CHECK( drift == Approx(du) );
+  CHECK( cb.info().find("CPU") != string::npos );
+  for (auto i : s.pol)
+    CHECK( s.spc.p[i].x() == Approx(s.spc.trial[i].x()) );
+
+  // monomers are regrown at their bond length to the remaining chain
+  vector<double> b = s.bondlengths();
+  for (size_t i=0; i<b.size(); i++)
+    CHECK( b[i] == Approx(b0[i]) );
+
+  // single monomers at either end, next to the salt preceding the chain
+  s.mcp.add("cbmc_minlen", 1);
+  s.mcp.add("cbmc_maxlen", 1);
+  Move::Regrowth cb1(s.mcp, s.pot, s.spc);
+  cb1.setGroup(s.pol);
+  Point ion = s.spc.p[s.pol.front()-1];
+  u0 = Energy::systemEnergy(s.spc,s.pot,s.spc.p);
+  du = cb1.move(400);
+  drift = Energy::systemEnergy(s.spc,s.pot,s.spc.p) - u0;
+  CHECK( cb1.getAcceptance()>0 );
+  CHECK( drift == Approx(du) );
+  CHECK( s.spc.geo->dist(ion, s.spc.p[s.pol.front()-1]) == Approx(0) );
+  b = s.bondlengths();
+  CHECK( b.front() == Approx(b0.front()) );
+  CHECK( b.back() == Approx(b0.back()) );
+
+  // interior monomers keep both bonds while the chain ends stay in place
+  s.mcp.add("cbmc_interior", 1.);
+  Move::Regrowth cb2(s.mcp, s.pot, s.spc);
+  cb2.setGroup(s.pol);
+  b0 = s.bondlengths();
+  Point front = s.spc.p[s.pol.front()], back = s.spc.p[s.pol.back()];
+  u0 = Energy::systemEnergy(s.spc,s.pot,s.spc.p);
+  du = cb2.move(400);
+  drift = Energy::systemEnergy(s.spc,s.pot,s.spc.p) - u0;
+  CHECK( cb2.getAcceptance()>0 );
+  CHECK( drift == Approx(du) );
+  CHECK( s.spc.geo->dist(front, s.spc.p[s.pol.front()]) == Approx(0) );
+  CHECK( s.spc.geo->dist(back, s.spc.p[s.pol.back()]) == Approx(0) );
+  b = s.bondlengths();
+  for (size_t i=0; i<b.size(); i++)
+    CHECK( b[i] == Approx(b0[i]) );
+}
+
+TEST_CASE("Polymer reptation", "Single monomer energy change for uniform chains")
+{
+  PolymerSystem s(25);
+  for (auto i : s.pol)
+    s.spc.p[i].charge = s.spc.trial[i].charge = 1;
+  Move::Reptation rep(s.mcp, s.pot, s.spc);
+  rep.setGroup(s.pol);
+
+  // accepted moves shift all monomers by one position along the chain
+  int n=s.pol.size()-1;
+  bool shifted=false;
+  for (int k=0; k<100 && !shifted; k++) {
+    p_vec old=s.spc.p;
+    rep.move(1);
+    int up=0, down=0, same=0;
+    for (int i=s.pol.front(); i<s.pol.back(); i++) {
+      up += s.spc.geo->dist(s.spc.p[i+1], old[i]) < 1e-9;
+      down += s.spc.geo->dist(s.spc.p[i], old[i+1]) < 1e-9;
+      same += s.spc.geo->dist(s.spc.p[i], old[i]) < 1e-9;
+    }
+    shifted = (up==n || down==n);
+    CHECK( (shifted || same==n) );
+  }
+  CHECK( shifted );
+
+  double u0 = Energy::systemEnergy(s.spc,s.pot,s.spc.p);
+  unsigned long n0 = rep.uniformCount();
+  double du = rep.move(300);
+  double drift = Energy::systemEnergy(s.spc,s.pot,s.spc.p) - u0;
+  CHECK( rep.getAcceptance()>0 );
+  CHECK( drift == Approx(du) );
+  n0 = rep.uniformCount()-n0;
+  CHECK( n0 == 300 );
+  Point cm = Geometry::massCenter(*s.spc.geo, s.spc.p, s.pol);
+  CHECK( s.spc.geo->dist(cm, s.pol.cm) == Approx(0) );
+
+  // non-uniform chain: full chain energy
+  s.spc.p[s.pol.front()].charge = s.spc.trial[s.pol.front()].charge = -1;
+  rep.setGroup(s.pol);
+  u0 = Energy::systemEnergy(s.spc,s.pot,s.spc.p);
+  n0 = rep.uniformCount();
+  du = rep.move(100);
+  drift = Energy::systemEnergy(s.spc,s.pot,s.spc.p) - u0;
+  CHECK( drift == Approx(du) );
+  CHECK( rep.uniformCount() == n0 );
+
+  // identical monomers but one different bond: full chain energy
+  s.spc.p[s.pol.front()].charge = s.spc.trial[s.pol.front()].charge = 1;
+  s.bonded->add(s.pol.front(), s.pol.front()+1, Potential::Harmonic(0.5,2.5));
+  Move::Reptation rep2(s.mcp, s.pot, s.spc);
+  rep2.setGroup(s.pol);
+  u0 = Energy::systemEnergy(s.spc,s.pot,s.spc.p);
+  du = rep2.move(100);
+  drift = Energy::systemEnergy(s.spc,s.pot,s.spc.p) - u0;
+  CHECK( drift == Approx(du) );
+  CHECK( rep2.uniformCount() == 0 );
+}
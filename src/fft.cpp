@@ -0,0 +1,148 @@
+#include <faunus/fft.h>
+#include <faunus/physconst.h>
+#ifdef FAU_FFTW
+#include <fftw3.h>
+#endif
+
+namespace Faunus {
+
+  FFT3D::FFT3D() : fftwbuf(nullptr) {
+    n[0]=n[1]=n[2]=0;
+    plan[0]=plan[1]=nullptr;
+  }
+
+  /** Plans are not shared - a copy creates its own */
+  FFT3D::FFT3D(const FFT3D &o) : FFT3D() {
+    *this=o;
+  }
+
+  FFT3D& FFT3D::operator=(const FFT3D &o) {
+    if (this!=&o && o.size()>0)
+      resize(o.n[0], o.n[1], o.n[2]);
+    return *this;
+  }
+
+  FFT3D::~FFT3D() {
+    cleanup();
+  }
+
+  void FFT3D::cleanup() {
+#ifdef FAU_FFTW
+    for (auto &p : plan)
+      if (p!=nullptr) {
+        fftw_destroy_plan( (fftw_plan)p );
+        p=nullptr;
+      }
+    if (fftwbuf!=nullptr)
+      fftw_free(fftwbuf);
+    fftwbuf=nullptr;
+#endif
+  }
+
+  int FFT3D::size() const { return n[0]*n[1]*n[2]; }
+
+  std::string FFT3D::backend() {
+#ifdef FAU_FFTW
+    return "FFTW3";
+#else
+    return "Bundled radix-2";
+#endif
+  }
+
+  int FFT3D::goodSize(int m) {
+#ifdef FAU_FFTW
+    return std::max(m,1);
+#else
+    int k=1;
+    while (k<m)
+      k*=2;
+    return k;
+#endif
+  }
+
+  void FFT3D::resize(int nx, int ny, int nz) {
+    assert(nx>0 && ny>0 && nz>0);
+    if (nx==n[0] && ny==n[1] && nz==n[2])
+      return;
+    cleanup();
+    n[0]=nx;
+    n[1]=ny;
+    n[2]=nz;
+#ifdef FAU_FFTW
+    fftwbuf = fftw_malloc( sizeof(fftw_complex)*size() );
+    fftw_complex *d = (fftw_complex*)fftwbuf;
+    plan[0] = (void*)fftw_plan_dft_3d(nz, ny, nx, d, d, FFTW_FORWARD, FFTW_ESTIMATE);
+    plan[1] = (void*)fftw_plan_dft_3d(nz, ny, nx, d, d, FFTW_BACKWARD, FFTW_ESTIMATE);
+#else
+    for (int d=0; d<3; d++)
+      assert( goodSize(n[d])==n[d] && "Mesh dimension must be a power of two");
+#endif
+  }
+
+  void FFT3D::forward(Tvec &v) {
+    assert((int)v.size()==size());
+#ifdef FAU_FFTW
+    std::copy(v.begin(), v.end(), (Tcomplex*)fftwbuf);
+    fftw_execute( (fftw_plan)plan[0] );
+    std::copy((Tcomplex*)fftwbuf, (Tcomplex*)fftwbuf+size(), v.begin());
+#else
+    transform(v,-1);
+#endif
+  }
+
+  void FFT3D::backward(Tvec &v) {
+    assert((int)v.size()==size());
+#ifdef FAU_FFTW
+    std::copy(v.begin(), v.end(), (Tcomplex*)fftwbuf);
+    fftw_execute( (fftw_plan)plan[1] );
+    std::copy((Tcomplex*)fftwbuf, (Tcomplex*)fftwbuf+size(), v.begin());
+#else
+    transform(v,1);
+#endif
+  }
+
+  /**
+   * Iterative radix-2 Cooley-Tukey transform applied to all lines
+   * in each of the three dimensions.
+   *
+   * @param v Data to transform
+   * @param sign Sign of the exponent (-1=forward, +1=backward)
+   */
+  void FFT3D::transform(Tvec &v, int sign) {
+    int stride[3] = {1, n[0], n[0]*n[1]};
+    for (int d=0; d<3; d++) {
+      int m=n[d], s=stride[d];
+      if (m<2)
+        continue;
+      buf.resize(m);
+      Tvec w(m/2);                                  // twiddle factors
+      for (int k=0; k<m/2; k++)
+        w[k]=std::polar(1.0, sign*2*pc::pi*k/m);
+      for (int hi=0; hi<size(); hi+=s*m)            // loop over all lines
+        for (int lo=0; lo<s; lo++) {                // along dimension d
+          int start=hi+lo;
+          for (int k=0; k<m; k++)
+            buf[k]=v[start+k*s];
+          for (int i=1, j=0; i<m; i++) {            // bit reversal
+            int bit=m>>1;
+            for (; j & bit; bit>>=1)
+              j^=bit;
+            j^=bit;
+            if (i<j)
+              std::swap(buf[i],buf[j]);
+          }
+          for (int len=2; len<=m; len<<=1)          // butterflies
+            for (int i=0; i<m; i+=len)
+              for (int k=0; k<len/2; k++) {
+                Tcomplex a=buf[i+k];
+                Tcomplex b=buf[i+k+len/2] * w[k*(m/len)];
+                buf[i+k] = a+b;
+                buf[i+k+len/2] = a-b;
+              }
+          for (int k=0; k<m; k++)
+            v[start+k*s]=buf[k];
+        }
+    }
+  }
+
+}//namespace
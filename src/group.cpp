@@ -120,12 +120,18 @@ namespace Faunus {
   void Group::undo(Space &s) {
     for (auto i : *this)
       s.trial[i]=s.p[i];
+    if (s.arraysEnabled())
+      for (auto i : *this)
+        s.trial_arr.set(i, s.p[i]);
     cm_trial=cm;
   }
 
   void Group::accept(Space &s) {
     for (auto i : *this)
       s.p[i] = s.trial[i];
+    if (s.arraysEnabled())
+      for (auto i : *this)
+        s.p_arr.set(i, s.trial[i]);
     cm=cm_trial;
   }
 
@@ -161,7 +161,12 @@ namespace Faunus {
 
   //----------------- IOXTC ----------------------
 
-  FormatXTC::FormatXTC(float len) {
+  /**
+   * @param len Initial cubic box length
+   * @param nqueue Number of frames that may be pending for the background
+   *        writer. If zero, frames are written immediately.
+   */
+  FormatXTC::FormatXTC(float len, unsigned int nqueue) : maxqueue(nqueue), done(false) {
     prec_xtc = 1000.;
     time_xtc=step_xtc=0;
     setbox(len);
@@ -169,6 +174,11 @@ namespace Faunus {
     x_xtc=NULL;
   }
 
+  FormatXTC::~FormatXTC() {
+    if (xd!=NULL)
+      close();
+  }
+
   void FormatXTC::setbox(double x, double y, double z) {
     assert(x>0 && y>0 && z>0);
     for (short i=0; i<3; i++)
@@ -183,9 +193,78 @@ namespace Faunus {
 
   void FormatXTC::setbox(const Point &p) { setbox(p.x(), p.y(), p.z()); }
 
+  bool FormatXTC::openWrite(string file) {
+    if (xd==NULL) {
+      xd=xdrfile_open(&file[0], "w");
+      if (xd!=NULL && maxqueue>0) {
+        done=false;
+        writer=std::thread(&FormatXTC::writeLoop, this);
+      }
+    }
+    return (xd!=NULL);
+  }
+
+  /**
+   * In synchronous mode the same buffer is always returned. Otherwise a
+   * previously written frame is re-used and, if the queue is full, we wait
+   * for the writer to catch up.
+   */
+  FormatXTC::Frame FormatXTC::getFrame(size_t n) {
+    Frame f;
+    if (maxqueue==0)
+      f=std::move(buffer);
+    else {
+      std::unique_lock<std::mutex> lock(mtx);
+      cv.wait(lock, [&]{ return queue.size()<maxqueue; });
+      if (!pool.empty()) {
+        f=std::move(pool.front());
+        pool.pop_front();
+      }
+    }
+    f.x.resize(3*n);
+    for (short i=0; i<3; i++)
+      for (short j=0; j<3; j++)
+        f.box[i][j]=xdbox[i][j];
+    f.step=step_xtc++;
+    f.time=time_xtc++;
+    return f;
+  }
+
+  void FormatXTC::putFrame(Frame &&f) {
+    if (maxqueue==0) {
+      write(f);
+      buffer=std::move(f);
+    } else {
+      std::lock_guard<std::mutex> lock(mtx);
+      queue.push_back(std::move(f));
+      cv.notify_all();
+    }
+  }
+
+  void FormatXTC::write(Frame &f) {
+    write_xtc(xd, f.x.size()/3, f.step, f.time, f.box, (rvec*)f.x.data(), prec_xtc);
+  }
+
+  void FormatXTC::writeLoop() {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (true) {
+      cv.wait(lock, [&]{ return !queue.empty() || done; });
+      if (queue.empty())
+        break;
+      Frame f=std::move(queue.front());
+      queue.pop_front();
+      lock.unlock();
+      write(f);
+      lock.lock();
+      pool.push_back(std::move(f));
+      cv.notify_all();
+    }
+  }
+
   /*!
    * Save all particles in Cuboid to xtc file. Molecules added to the ioxtc::g
-   * vector will be made whole (periodic boundaries are temporarily undone). Box
+   * vector will be made whole using their mass centers and the minimum image
+   * convention, leaving `Space` untouched. Box
    * dimensions are taken from the Cuboid class and the particles are shifted so
    * that origin is in the corner of the box (Gromacs practice)
    *
@@ -195,19 +274,27 @@ namespace Faunus {
   bool FormatXTC::save(string file, Space &c) {
     Geometry::Cuboid* geo = dynamic_cast<Geometry::Cuboid*>(c.geo);
     assert(geo!=nullptr && "Only Cuboid geometries classes allowed.");
-    if (geo==nullptr)
+    if (geo==nullptr || !openWrite(file))
       return false;
     setbox(geo->len.x(), geo->len.y(), geo->len.z());
-    p=c.p;
-    for (auto gi : g) {
-      gi->translate( c, -gi->cm );             // b.trial is moved to origo -> whole!
-      for (auto j : *gi)
-        p[j] = c.trial[j] + gi->cm;            // move back to cm without periodicity
-      gi->undo(c);                             // restore to original PBC location
+    Frame f=getFrame(c.p.size());
+    float *x=f.x.data();
+    for (auto &pi : c.p) {
+      Point a = (pi + geo->len_half) * 0.1;    // gromacs origo is in the corner of the box
+      *x++ = a.x();                            // while in Cuboid we use the middle
+      *x++ = a.y();
+      *x++ = a.z();
     }
-    for (auto &pi : p)
-      pi+=geo->len_half;                       // gromacs origo is in the corner of the box
-    return save(file, p);                      // while in Cuboid we use the middle
+    for (auto gi : g)
+      for (auto j : *gi) {
+        Point a = (gi->cm + geo->vdist(c.p[j], gi->cm) + geo->len_half) * 0.1;
+        x = &f.x[3*j];
+        x[0] = a.x();
+        x[1] = a.y();
+        x[2] = a.z();
+      }
+    putFrame(std::move(f));
+    return true;
   }
 
   /*!
@@ -217,22 +304,17 @@ namespace Faunus {
    * set by the ioxtc::setbox() function before calling this.
    */
   bool FormatXTC::save(string file, const p_vec &p) {
-    if (xd==NULL)
-      xd=xdrfile_open(&file[0], "w");
-    if (xd!=NULL) {
-      rvec *x = new rvec [p.size()];
-      int i=0;
-      for (auto &pi : p) {
-        x[i][0] = (pi.x() ) * 0.1;      // AA->nm
-        x[i][1] = (pi.y() ) * 0.1;
-        x[i][2] = (pi.z() ) * 0.1;
-        i++;
-      }
-      write_xtc(xd,p.size(),step_xtc++,time_xtc++,xdbox,x,prec_xtc);
-      delete[] x;
-      return true;
+    if (!openWrite(file))
+      return false;
+    Frame f=getFrame(p.size());
+    float *x=f.x.data();
+    for (auto &pi : p) {
+      *x++ = pi.x() * 0.1;      // AA->nm
+      *x++ = pi.y() * 0.1;
+      *x++ = pi.z() * 0.1;
     }
-    return false;
+    putFrame(std::move(f));
+    return true;
   }
 
   bool FormatXTC::save(string file, p_vec &p, std::vector<Group> &g) {
@@ -243,10 +325,22 @@ namespace Faunus {
     return save(file, t);
   }
 
+  /**
+   * Pending frames are written before the file is closed
+   */
   void FormatXTC::close() {
+    if (writer.joinable()) {
+      {
+        std::lock_guard<std::mutex> lock(mtx);
+        done=true;
+      }
+      cv.notify_all();
+      writer.join();
+    }
     xdrfile_close(xd);
     xd=NULL;
     delete[] x_xtc;
+    x_xtc=NULL;
   }
 
   /*!
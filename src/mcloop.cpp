@@ -1,6 +1,7 @@
 #include <faunus/mcloop.h>
 #include <faunus/inputfile.h>
 #include <faunus/textio.h>
+#include <faunus/checkpoint.h>
 
 namespace Faunus {
 
@@ -8,9 +9,30 @@ namespace Faunus {
     string prefix=pfx;
     macro=in.get<int>(prefix+"macrosteps",10);
     micro=in.get<int>(prefix+"microsteps",0);
+    ckinterval=in.get<int>(prefix+"checkpoint",0);
+    ckpt=nullptr;
     cnt_micro=cnt_macro=0;
   }
 
+  /**
+   * The loop counters are added to the checkpoint under the key `mcloop`
+   */
+  void MCLoop::setCheckpoint(Checkpoint &c) {
+    ckpt=&c;
+    ckpt->add("mcloop", *this);
+  }
+
+  void MCLoop::save(std::ostream &o) {
+    Binary::write(o,cnt_macro);
+    Binary::write(o,cnt_micro);
+  }
+
+  bool MCLoop::load(std::istream &in) {
+    Binary::read(in,cnt_macro);
+    Binary::read(in,cnt_micro);
+    return bool(in);
+  }
+
   string MCLoop::info() {
     using namespace textio;
     char w=25;
@@ -44,10 +66,12 @@ namespace Faunus {
 
   /*!
    * Increase macroloop counter and test if the
-   * maximum value has been reached. Whenever called
-   * this function saves a state file to disk
+   * maximum value has been reached. If a checkpoint is set,
+   * it is saved after every `loop_checkpoint` completed macrosteps.
    */
   bool MCLoop::macroCnt() {
+    if (ckpt!=nullptr && ckinterval>0 && cnt_macro>0 && cnt_macro%ckinterval==0)
+      ckpt->save();
     return (++cnt_macro>macro) ? false : true;
   }
 
@@ -8,6 +8,7 @@
 #include <faunus/geometry.h>
 #include <faunus/textio.h>
 #include <faunus/physconst.h>
+#include <faunus/checkpoint.h>
 
 namespace Faunus {
 
@@ -19,7 +20,7 @@ namespace Faunus {
       pot=&e;
       spc=&s;
       prefix=pfx;
-      cnt=cnt_accepted=0;
+      cnt=cnt_accepted=cnt_early=0;
       dusum=0;
       w=22;
       runfraction=1;
@@ -32,16 +33,26 @@ namespace Faunus {
     void Movebase::trialMove() {
       assert(spc->geo!=nullptr && "Space geometry MUST be set before moving!");
       cnt++;
+      changed.clear();
       _trialMove();
+      if (spc->arraysEnabled())
+        spc->syncArrays(changed);
+      pot->trialUpdate(*spc, changed);
     }
 
     void Movebase::acceptMove() {
       cnt_accepted++;
       _acceptMove();
+      if (spc->arraysEnabled())
+        spc->syncArrays(changed);
+      pot->acceptUpdate(changed);
     }
     
     void Movebase::rejectMove() {
       _rejectMove();
+      if (spc->arraysEnabled())
+        spc->syncArrays(changed);
+      pot->rejectUpdate(changed);
     }
    
     /** @return Energy change in units of kT */
@@ -59,6 +70,12 @@ namespace Faunus {
      * - Accept with probability \f$ \min(1,e^{-\beta\Delta U}) \f$
      * - Call either `_acceptMove()` or `_rejectMove()`
      *
+     * An energy evaluation may stop and return `pc::infty` as soon as a term
+     * is infinite, see `Energy::Energybase`. A finite partial sum cannot bound
+     * the remaining, possibly attractive, terms and so infinity is the only
+     * point where evaluation stops early. Such early rejections are counted
+     * and reported by `info()`.
+     *
      * @note Do not override this function in derived classes.
      * @param n Perform move `n` times (default=1)
      */
@@ -68,6 +85,8 @@ namespace Faunus {
         while (n-->0) {
           trialMove();
           double du=energyChange();
+          if (du>=pc::infty)
+            cnt_early++;
           if ( !metropolis(du) )
             rejectMove();
           else {
@@ -84,7 +103,7 @@ namespace Faunus {
     }
 
     bool Movebase::metropolis(const double &du) const {
-      if ( slp_global()>std::exp(-du) ) // core of MC!
+      if ( du>=pc::infty || slp_global()>std::exp(-du) ) // core of MC!
         return false;
       return true;
     }
@@ -105,6 +124,32 @@ namespace Faunus {
     void Movebase::_test(UnitTest&) {
     }
 
+    void Movebase::_save(std::ostream&) {}
+
+    bool Movebase::_load(std::istream&) { return true; }
+
+    /**
+     * Writes the move counters and the runfraction, followed by the state of
+     * derived classes via `_save()`. Used with `Checkpoint`.
+     */
+    void Movebase::save(std::ostream &o) {
+      Binary::write(o,cnt);
+      Binary::write(o,cnt_accepted);
+      Binary::write(o,cnt_early);
+      Binary::write(o,dusum);
+      Binary::write(o,runfraction);
+      _save(o);
+    }
+
+    bool Movebase::load(std::istream &in) {
+      Binary::read(in,cnt);
+      Binary::read(in,cnt_accepted);
+      Binary::read(in,cnt_early);
+      Binary::read(in,dusum);
+      Binary::read(in,runfraction);
+      return _load(in) && bool(in);
+    }
+
     double Movebase::getAcceptance() {
       if (cnt>0)
         return double(cnt_accepted) / cnt;
@@ -136,6 +181,7 @@ namespace Faunus {
       if (cnt>0)
         o << pad(SUB,w,"Number of trials") << cnt << endl
           << pad(SUB,w,"Acceptance") << getAcceptance()*100 << percent << endl
+          << pad(SUB,w,"Early rejection") << double(cnt_early)/cnt*100 << percent << endl
           << pad(SUB,w,"Runfraction") << runfraction*100 << percent << endl
           << pad(SUB,w,"Total energy change") << dusum << kT << endl;
       o << _info();
@@ -202,6 +248,7 @@ namespace Faunus {
         t.y() *= slp_global()-0.5;
         t.z() *= slp_global()-0.5;
         spc->trial[iparticle].translate(*spc->geo, t);
+        changed.insert(iparticle);
 
         // make sure trial mass center is updated for molecular groups
         // (certain energy functions may rely on up-to-date mass centra)
@@ -237,11 +284,26 @@ namespace Faunus {
         if ( spc->geo->collision( spc->trial[iparticle], Geometry::Geometrybase::BOUNDARY ) )
           return pc::infty;
         return
-          pot->i_total(spc->trial, iparticle) - pot->i_total(spc->p, iparticle);
+          pot->i_total_change(spc->trial, spc->p, iparticle);
       }
       return 0;
     }
 
+    void AtomicTranslation::_save(std::ostream &o) {
+      Binary::write(o,genericdp);
+      Binary::write(o,accmap);
+      Binary::write(o,sqrmap);
+      Binary::write(o,gsize);
+    }
+
+    bool AtomicTranslation::_load(std::istream &in) {
+      Binary::read(in,genericdp);
+      Binary::read(in,accmap);
+      Binary::read(in,sqrmap);
+      Binary::read(in,gsize);
+      return bool(in);
+    }
+
     string AtomicTranslation::_info() {
       std::ostringstream o;
       if (gsize.cnt>0)
@@ -291,6 +353,7 @@ namespace Faunus {
         u.ranunit(slp_global);
         rot.setAxis( *spc->geo, Point(0,0,0), u, dprot*slp_global.randHalf() );
         spc->trial[iparticle].rotate(rot);
+        changed.insert(iparticle);
       }
     }
 
@@ -371,6 +434,7 @@ namespace Faunus {
         p.z()=dir.z() * dp_trans * slp_global.randHalf();
         igroup->translate(*spc, p);
       }
+      changed.insert(*igroup);
     }
 
     void TranslateRotate::_acceptMove() {
@@ -401,6 +465,14 @@ namespace Faunus {
         return pc::infty;       // early rejection
       double uold = pot->g_external(spc->p, *igroup);
 
+      auto ham = dynamic_cast<Energy::Hamiltonian*>(pot);
+      if (ham!=nullptr && ham->groupCache()!=nullptr) {
+        double du = ham->groupCache()->trialRow(spc->trial, *igroup);
+        if (du==pc::infty)
+          return pc::infty;     // early rejection
+        return unew + du - uold - ham->groupCache()->row(*igroup);
+      }
+
       for (auto g : spc->groupList()) {
         if (g!=igroup) {
           unew += pot->g2g(spc->trial, *g, *igroup);
@@ -441,6 +513,23 @@ namespace Faunus {
       return o.str();
     }
 
+    void TranslateRotate::_save(std::ostream &o) {
+      Binary::write(o,dp_trans);
+      Binary::write(o,dp_rot);
+      Binary::write(o,accmap);
+      Binary::write(o,sqrmap_t);
+      Binary::write(o,sqrmap_r);
+    }
+
+    bool TranslateRotate::_load(std::istream &in) {
+      Binary::read(in,dp_trans);
+      Binary::read(in,dp_rot);
+      Binary::read(in,accmap);
+      Binary::read(in,sqrmap_t);
+      Binary::read(in,sqrmap_r);
+      return bool(in);
+    }
+
     void TranslateRotate::_test(UnitTest &t) {
       for (auto m : accmap) {                                                                                   
         string id=m.first,
@@ -516,6 +605,8 @@ namespace Faunus {
         for (auto i : cindex)
           spc->trial[i].translate(*spc->geo,p);
       }
+      changed.insert(*igroup);
+      changed.insert(cindex.begin(), cindex.end());
     }
 
     void TranslateRotateCluster::_acceptMove() {
@@ -688,43 +779,48 @@ namespace Faunus {
       assert(!index.empty() && "No particles to rotate.");
       for (auto i : index)
         spc->trial[i] = vrot(spc->p[i]); // (boundaries are accounted for)
+      changed.insert(index.begin(), index.end());
+      changed.groups.insert(gPtr);
       gPtr->cm_trial = Geometry::massCenter( *spc->geo, spc->trial, *gPtr);
     }
 
     void CrankShaft::_acceptMove() {
       double msq=0;
-      for (auto i : index) {
+      for (auto i : index)
         msq+=spc->geo->sqdist( spc->p[i], spc->trial[i] );
-        spc->p[i] = spc->trial[i];
-      }
       accmap.accept(gPtr->name, msq ) ;
-      gPtr->cm = gPtr->cm_trial;
+      spc->accept(changed);
     }
 
     void CrankShaft::_rejectMove() {
       accmap.reject(gPtr->name);
-      for (auto i : index)
-        spc->trial[i] = spc->p[i];
-      gPtr->cm_trial = gPtr->cm;
+      spc->undo(changed);
     }
 
-    /*!
-     * \todo g_internal is not really needed - index<->g would be faster
+    /**
+     * Only interactions involving the rotated particles are evaluated: the
+     * energy change of each rotated particle with the rest of the system, i.e.
+     * the rest of the chain, other groups, bonds and external potentials, is
+     * found by `Energy::Energybase::i_total_change()`. Pairs within the
+     * rotated segment are thereby counted twice and are subtracted. For `k`
+     * rotated particles and `N` particles in total, this scales as
+     * \f$O(kN)\f$ rather than with the square of the chain length as the
+     * internal energy of the whole chain.
      */
     double CrankShaft::_energyChange() {
       double du=0;
       for (auto i : index)
         if ( spc->geo->collision( spc->trial[i], Geometry::Geometrybase::BOUNDARY ) )
           return pc::infty;
-      du=pot->g_internal(spc->trial, *gPtr) - pot->g_internal(spc->p, *gPtr);
-      for (auto i : index)
-        du+=pot->i_external(spc->trial,i) - pot->i_external(spc->p,i);
-      for (auto g : spc->groupList())
-        if (g!=gPtr)
-          du+=pot->g2g(spc->trial, *g, *gPtr) - pot->g2g(spc->p, *g, *gPtr);
-
-      //for (auto i : index)
-      //  du += pot->i2all(spc->trial, i) - pot->i2all(spc->p, i);
+      for (auto i : index) {
+        double u=pot->i_total_change(spc->trial, spc->p, i);
+        if (u>=pc::infty)
+          return pc::infty;     // early rejection
+        du+=u;
+      }
+      for (size_t a=0; a+1<index.size(); a++)  // rotated-rotated pairs
+        for (size_t b=a+1; b<index.size(); b++)
+          du-=pot->i2i(spc->trial, index[a], index[b]) - pot->i2i(spc->p, index[a], index[b]);
       return du;
     }
 
@@ -803,9 +899,88 @@ namespace Faunus {
       runfraction = in.get<double>(prefix+"_runfraction",1.0);
       bondlength = in.get<double>(prefix+"_bondlength", -1);
       gPtr=nullptr;
+      first=leaving=-1;
+      uniform=false;
+      uniformcheck=-1;
+      cntuniform=0;
+    }
+
+    /** @brief Test if two particles have identical properties, positions excluded */
+    static inline bool sameProperties(const PointParticle &a, const PointParticle &b) {
+      return a.id==b.id && a.charge==b.charge && a.radius==b.radius
+        && a.mw==b.mw && a.hydrophobic==b.hydrophobic;
+    }
+
+    static inline bool sameProperties(const DipoleParticle &a, const DipoleParticle &b) {
+      const PointParticle &pa=a, &pb=b;
+      return sameProperties(pa, pb)
+        && a.mu==b.mu && a.muscalar==b.muscalar;
     }
 
-    void Reptation::setGroup(Group &g) { gPtr=&g; }
+    static inline bool sameProperties(const CigarParticle &a, const CigarParticle &b) {
+      const PointParticle &pa=a, &pb=b;
+      return sameProperties(pa, pb)
+        && a.dir==b.dir && a.patchdir==b.patchdir && a.chdir==b.chdir
+        && a.patchsides[0]==b.patchsides[0] && a.patchsides[1]==b.patchsides[1]
+        && a.patchangle==b.patchangle && a.pcanglsw==b.pcanglsw
+        && a.pcangl==b.pcangl && a.halfl==b.halfl;
+    }
+
+    /**
+     * The result is cached until the next call to `setGroup()`.
+     */
+    bool Reptation::isUniform() {
+      if (uniformcheck<0) {
+        auto &a=spc->p[gPtr->front()];
+        uniformcheck=1;
+        for (auto i : *gPtr)
+          if ( !sameProperties(a, spc->p[i]) ) {
+            uniformcheck=0;
+            break;
+          }
+        if (uniformcheck==1)
+          uniformcheck=uniformBonds();
+      }
+      return uniformcheck==1;
+    }
+
+    /**
+     * A copy of the particle vector is made where the chain is placed on a
+     * straight line, and the pair energies of all nearest and next-nearest
+     * neighbours are compared with those at the front of the chain. This is
+     * done for the current first bond length and a slightly larger spacing.
+     */
+    bool Reptation::uniformBonds() {
+      int n=gPtr->size();
+      if (n<2)
+        return true;
+      p_vec probe=spc->p;
+      double bond=spc->geo->dist(spc->p[gPtr->front()], spc->p[gPtr->front()+1]);
+      for (double d : {bond, 1.2*bond}) {
+        for (int k=0; k<n; k++) {
+          int i=gPtr->front()+k;
+          probe[i]=spc->p[gPtr->front()] + Point(d*k,0,0);
+          spc->geo->boundary(probe[i]);
+        }
+        for (int k=1; k<=2 && k<n; k++) {
+          double u0=pot->i2i(probe, gPtr->front(), gPtr->front()+k);
+          for (int i=gPtr->front()+1; i+k<=gPtr->back(); i++) {
+            double u=pot->i2i(probe, i, i+k);
+            if (u0>=pc::infty || u>=pc::infty) {
+              if (u!=u0)
+                return false;
+            } else if ( std::abs(u-u0) > 1e-9*std::max(1.,std::abs(u0)) )
+              return false;
+          }
+        }
+      }
+      return true;
+    }
+
+    void Reptation::setGroup(Group &g) {
+      gPtr=&g;
+      uniformcheck=-1;
+    }
 
     void Reptation::_test(UnitTest &t) {
       accmap._test(t, prefix);
@@ -813,16 +988,19 @@ namespace Faunus {
 
     void Reptation::_trialMove() {
       assert(gPtr!=nullptr && "Did you forget to call setGroup?");
+      uniform=false;
       if (gPtr->size()<2)
         return;
 
-      int first, second; // "first" is end point, "second" is the neighbor
+      int second; // "first" is end point, "second" is the neighbor
       if (slp_global.randHalf()>0) {
         first=gPtr->front();
         second=first+1;
+        leaving=gPtr->back();
       } else {
         first=gPtr->back();
         second=first-1;
+        leaving=gPtr->front();
       }
 
       double bond;
@@ -831,7 +1009,7 @@ namespace Faunus {
       else
         bond=spc->geo->dist(spc->p[first], spc->p[second]); // bond length of first or last particle
 
-      // shift particles up or down
+      // shift particles up or down - positions in `p` already obey boundaries
       for (int i=gPtr->front(); i<gPtr->back(); i++)
         if (first<second)
           spc->trial[i+1]=Point( spc->p[i] );
@@ -843,11 +1021,17 @@ namespace Faunus {
       u.ranunit(slp_global);                          // generate random unit vector
       spc->trial[first].translate(*spc->geo, u*bond); // trans. 1st w. scaled unit vector
       assert( std::abs( spc->geo->dist(spc->p[first],spc->trial[first])-bond ) < 1e-7  );
+      changed.insert(*gPtr);
 
-      for (auto i : *gPtr)
-        spc->geo->boundary( spc->trial[i] );  // respect boundary conditions
-
-      gPtr->cm_trial = Geometry::massCenter( *spc->geo, spc->trial, *gPtr);
+      uniform=isUniform();
+      if (uniform && spc->p[first].mw>1e-6) {
+        // only the leaving monomer is replaced by the new end
+        Point d = spc->geo->vdist(spc->trial[first], gPtr->cm)
+          - spc->geo->vdist(spc->p[leaving], gPtr->cm);
+        gPtr->cm_trial = gPtr->cm + d/gPtr->size();
+        spc->geo->boundary(gPtr->cm_trial);
+      } else
+        gPtr->cm_trial = Geometry::massCenter( *spc->geo, spc->trial, *gPtr);
     }
 
     void Reptation::_acceptMove() {
@@ -860,7 +1044,23 @@ namespace Faunus {
       gPtr->undo(*spc);
     }
 
+    /**
+     * For uniform chains, the shifted monomers in `trial` occupy the same
+     * positions as the non-leaving monomers in `p` and only the new end
+     * monomer and the leaving monomer contribute to the energy change.
+     */
     double Reptation::_energyChange() {
+      if (gPtr->size()<2)
+        return 0;
+      if (uniform) {
+        if ( spc->geo->collision( spc->trial[first], Geometry::Geometrybase::BOUNDARY ) )
+          return pc::infty;
+        cntuniform++;
+        double unew = pot->i_total(spc->trial, first);
+        if (unew==pc::infty)
+          return pc::infty;     // early rejection
+        return unew - pot->i_total(spc->p, leaving);
+      }
       for (auto i : *gPtr)
         if ( spc->geo->collision( spc->trial[i], Geometry::Geometrybase::BOUNDARY ) )
           return pc::infty;
@@ -886,18 +1086,232 @@ namespace Faunus {
       std::ostringstream o;
       o << pad(SUB,w, "Bondlength") << bondlength << _angstrom + " (-1 = automatic)\n";
       if (cnt>0)
+        o << pad(SUB,w, "Single monomer energies") << cntuniform/double(cnt)*100 << percent << endl
+          << accmap.info();
+      return o.str();
+    }
+
+    Regrowth::Regrowth(InputMap &in, Energy::Energybase &e, Space &s, string pfx) : Movebase(e,s,pfx) {
+      title="Configurational-Bias Regrowth";
+      cite="doi:10.1080/00268979200100061";
+      w=30;
+      gPtr=nullptr;
+      minlen = in.get<int>(prefix+"_minlen", 1, "Min. monomers to regrow");
+      maxlen = in.get<int>(prefix+"_maxlen", 4, "Max. monomers to regrow");
+      ntrial = in.get<int>(prefix+"_ntrial", 10, "Trial positions per monomer");
+      interior = in.get<double>(prefix+"_interior", 0., "Fraction of interior monomer moves");
+      runfraction = in.get<double>(prefix+"_runfraction", 1.);
+      assert(minlen>0 && minlen<=maxlen && ntrial>0);
+      du=cputime=sqrsum=0;
+      dir=1;
+      tstart=0;
+      useAlternateReturnEnergy=true; // return energy, not Rosenbluth weight ratio
+    }
+
+    void Regrowth::setGroup(Group &g) { gPtr=&g; }
+
+    /**
+     * @param retrace If true, the first trial position of each monomer is
+     *        its position in `Space::p` which is also the one picked
+     * @param usum Energy of the picked positions (kT)
+     * @return Logarithm of the Rosenbluth weight (`-pc::infty` if all trial
+     *         positions of a monomer have infinite energy)
+     *
+     * Monomers are placed in `Space::trial`. The not yet grown monomers are
+     * those in `index` after the current one, which form a contiguous range
+     * at the end of the chain. All trial positions of a monomer are
+     * generated before they are scored.
+     */
+    double Regrowth::grow(bool retrace, double &usum) {
+      double lnW=0;
+      int N=spc->p.size();
+      usum=0;
+      for (size_t s=0; s<index.size(); s++) {
+        int m=index[s];
+
+        // particles in place: all but the monomers to be grown after m
+        Group a, b;
+        if (dir>0) {
+          a=Group(0, m);
+          b=Group(index.back()+1, N-1);
+        } else if (dir<0) {
+          a=Group(m, N-1);
+          b=Group(0, index.back()-1);
+        } else
+          a=Group(0, N-1);
+
+        for (int t=0; t<ntrial; t++)
+          if (retrace && t==0)
+            pos[t]=spc->p[m];
+          else
+            pos[t]=trialPosition(m);
+
+        double umin=pc::infty;
+        for (int t=0; t<ntrial; t++) {
+          spc->trial[m]=pos[t];
+          if (spc->arraysEnabled())
+            spc->syncArrays(m);
+          u[t]=pc::infty;
+          if ( !spc->geo->collision( spc->trial[m], Geometry::Geometrybase::BOUNDARY ) ) {
+            u[t]=pot->i_external(spc->trial, m);
+            if (u[t]<pc::infty)
+              u[t]+=pot->i2g(spc->trial, a, m);
+            if (u[t]<pc::infty && !b.empty())
+              u[t]+=pot->i2g(spc->trial, b, m);
+            if (u[t]<pc::infty)
+              u[t]+=pot->i_internal(spc->trial, m);
+          }
+          umin=std::min(umin, u[t]);
+        }
+        if (umin>=pc::infty)
+          return -pc::infty; // dead end
+
+        double wsum=0;
+        for (int t=0; t<ntrial; t++)
+          wsum+=std::exp(-(u[t]-umin));
+        lnW += std::log(wsum) - umin;
+
+        int pick=0;
+        if (!retrace) {
+          double r=slp_global()*wsum;
+          for (pick=0; pick<ntrial-1; pick++) {
+            r-=std::exp(-(u[pick]-umin));
+            if (r<0)
+              break;
+          }
+        }
+        spc->trial[m]=pos[pick];
+        if (spc->arraysEnabled())
+          spc->syncArrays(m);
+        usum+=u[pick];
+      }
+      return lnW;
+    }
+
+    /**
+     * Chain end monomers are placed on a sphere around their predecessor
+     * and interior monomers on the circle where the spheres around both
+     * neighbours intersect. The radii are the bond lengths in `Space::p` so
+     * that the old position is a possible trial position as well.
+     */
+    Point Regrowth::trialPosition(int m) {
+      Point r;
+      if (dir!=0) {
+        Point v;
+        v.ranunit(slp_global);
+        r=spc->trial[m-dir] + v*spc->geo->dist( spc->p[m], spc->p[m-dir] );
+      } else {
+        double b1=spc->geo->sqdist( spc->p[m], spc->p[m-1] );
+        double b2=spc->geo->sqdist( spc->p[m], spc->p[m+1] );
+        Point d=spc->geo->vdist( spc->p[m+1], spc->p[m-1] );
+        double D=d.norm();
+        Point n=d/D;
+        double h=(D*D+b1-b2)/(2*D);          // distance from m-1 to circle center
+        double rho=std::sqrt( std::max(0., b1-h*h) );
+        Point e1 = (std::abs(n.x())<0.9) ? Point(1,0,0) : Point(0,1,0);
+        e1=(e1-n*n.dot(e1)).normalized();
+        Point e2=n.cross(e1);
+        double phi=2*pc::pi*slp_global();
+        r=spc->p[m-1] + n*h + rho*(std::cos(phi)*e1 + std::sin(phi)*e2);
+      }
+      spc->geo->boundary(r);
+      return r;
+    }
+
+    void Regrowth::_trialMove() {
+      assert(gPtr!=nullptr && "No group to regrow. Did you forget to call setGroup?");
+      tstart=std::clock();
+      index.clear();
+      du=alternateReturnEnergy=0;
+      int n=gPtr->size();
+      if (n<2)
+        return;
+      if (n>2 && slp_global()<interior) {
+        dir=0;
+        index.push_back( gPtr->front()+1 + int(slp_global()*(n-2)) );
+      } else {
+        int k=std::min( minlen + int(slp_global()*(maxlen-minlen+1)), n-1 );
+        dir = (slp_global.randHalf()>0) ? 1 : -1;
+        if (dir>0)
+          for (int i=gPtr->back()-k+1; i<=gPtr->back(); i++)
+            index.push_back(i);
+        else
+          for (int i=gPtr->front()+k-1; i>=gPtr->front(); i--)
+            index.push_back(i);
+      }
+      changed.insert(index.begin(), index.end());
+      changed.groups.insert(gPtr);
+      u.resize(ntrial);
+      pos.resize(ntrial);
+
+      double uold, unew;
+      double lnWold=grow(true, uold);
+      double lnWnew=grow(false, unew);
+      if (lnWnew==-pc::infty) {
+        for (auto i : index)
+          spc->trial[i]=spc->p[i];
+        du=pc::infty;
+      } else {
+        du=lnWold-lnWnew;
+        alternateReturnEnergy=unew-uold;
+      }
+      gPtr->cm_trial = Geometry::massCenter( *spc->geo, spc->trial, *gPtr);
+    }
+
+    /** @return \f$-\ln(W_{new}/W_{old})\f$ which enters the Metropolis criterion as an energy */
+    double Regrowth::_energyChange() {
+      return du;
+    }
+
+    void Regrowth::_acceptMove() {
+      double msq=0;
+      for (auto i : index)
+        msq+=spc->geo->sqdist( spc->p[i], spc->trial[i] );
+      accmap.accept(gPtr->name, msq);
+      sqrsum+=msq;
+      spc->accept(changed);
+      cputime+=double(std::clock()-tstart)/CLOCKS_PER_SEC;
+    }
+
+    void Regrowth::_rejectMove() {
+      accmap.reject(gPtr->name);
+      spc->undo(changed);
+      cputime+=double(std::clock()-tstart)/CLOCKS_PER_SEC;
+    }
+
+    string Regrowth::_info() {
+      using namespace textio;
+      std::ostringstream o;
+      o << pad(SUB,w, "Min/max length to regrow") << minlen << " " << maxlen << endl
+        << pad(SUB,w, "Interior monomer moves") << interior*100 << percent << endl
+        << pad(SUB,w, "Trial positions") << ntrial << endl;
+      if (cnt>0) {
+        o << pad(SUB,w, "CPU time") << cputime << " s" << endl;
+        if (cputime>0)
+          o << pad(SUB,w, "Msq. displacement/CPU time") << sqrsum/cputime
+            << _angstrom+squared+"/s" << endl;
         o << accmap.info();
+      }
       return o.str();
     }
 
+    void Regrowth::_test(UnitTest &t) {
+      accmap._test(t, prefix);
+    }
+
     Isobaric::Isobaric(InputMap &in, Energy::Hamiltonian &e, Space &s, string pfx) : Movebase(e,s,pfx) {
       title="Isobaric Volume Fluctuations";
       w=30;
       dV = in.get<double>(prefix+"_dV", 0., "NPT volume displacement parameter");
       P = in.get<double>(prefix+"_P", 0., "NPT external pressure P/kT (mM)")/1e30*pc::Nav; //pressure mM -> 1/A^3
       runfraction = in.get<double>(prefix+"_runfraction",1.0);
+      usepowers = in.get<bool>(prefix+"_powers", false);
+      validate = in.get<bool>(prefix+"_validate", false);
       if (dV<1e-6)
         runfraction=0;
+      predicted=false;
+      cntpredict=0;
+      maxerr=0;
       hamiltonian = &e;
       e.create( Energy::ExternalPressure( e.getGeometry(), P ) );
     }
@@ -937,6 +1351,11 @@ namespace Faunus {
           << setw(l) << std::cbrt(V.avg()) << _angstrom
           << setw(l) << rV.avg() << " 1/" << _angstrom << cubed
           << setw(l) << N*rV.avg()*tomM << " mM\n";
+        if (usepowers || cntpredict>0) {
+          o << endl << pad(SUB,w, "Predicted energy changes") << cntpredict/double(cnt)*100 << percent << endl;
+          if (validate)
+            o << pad(SUB,w, "Max. prediction error") << maxerr << kT << endl;
+        }
       }
       return o.str();
     }
@@ -951,8 +1370,11 @@ namespace Faunus {
           && "Space has empty group vector - NPT move not possible.");
       oldV = spc->geo->getVolume();
       newV = std::exp( std::log(oldV) + slp_global.randHalf()*dV );
-      for (auto g : spc->groupList())
+      for (auto g : spc->groupList()) {
         g->scale(*spc, newV); // scale trial coordinates to new volume
+        changed.groups.insert(g);
+      }
+      changed.volume=true;
     }
 
     void Isobaric::_acceptMove() {
@@ -962,6 +1384,12 @@ namespace Faunus {
       hamiltonian->setVolume(newV);
       for (auto g : spc->groupList() )
         g->accept(*spc);
+      if (predicted) {
+        double s=std::cbrt(newV/oldV);
+        for (auto &u : powers)
+          u.second *= std::pow(s, -u.first);
+        pcache=spc->p;
+      }
     }
 
     void Isobaric::_rejectMove() {
@@ -994,12 +1422,76 @@ namespace Faunus {
       return u + pot->external();
     }
 
+    /** @brief External energy of all groups and of the system */
+    double Isobaric::_external(const p_vec &p) {
+      double u=0;
+      for (auto g : spc->groupList())
+        u += pot->g_external(p, *g);
+      return u + pot->external();
+    }
+
+    /**
+     * True if the pair energy can be predicted from its inverse power
+     * components, i.e. if enabled, if the geometry scales isotropically and
+     * if all particles belong to atomic groups.
+     */
+    bool Isobaric::predictable() {
+      if (!usepowers || !spc->geo->isotropic())
+        return false;
+      size_t n=0;
+      for (auto g : spc->groupList()) {
+        if (!g->isAtomic())
+          return false;
+        n+=g->size();
+      }
+      return n==spc->p.size();
+    }
+
+    /**
+     * Recalculates the inverse power components if positions or properties
+     * of any particle differ from those used in the last calculation. As
+     * energy terms may be added to the Hamiltonian at any time, it is first
+     * checked with an empty particle vector that the Hamiltonian can still be
+     * decomposed.
+     */
+    bool Isobaric::updatePowers() {
+      std::map<int,double> m;
+      if (!pot->all2all_powers(p_vec(), m)) {
+        pcache.clear();
+        return false;
+      }
+      bool same = (pcache.size()==spc->p.size());
+      for (size_t i=0; i<pcache.size() && same; i++) {
+        const particle &a=pcache[i], &b=spc->p[i];
+        same = (a==b && a.charge==b.charge && a.radius==b.radius && a.id==b.id);
+      }
+      if (!same) {
+        powers.clear();
+        pcache.clear();
+        pot->all2all_powers(spc->p, powers);
+        pcache=spc->p;
+      }
+      return true;
+    }
+
+    /** @brief Pair energy with all distances scaled by `s` */
+    double Isobaric::powerEnergy(double s) const {
+      double u=0;
+      for (auto &i : powers)
+        u += i.second * std::pow(s, -i.first);
+      return u;
+    }
+
     /**
      * @todo Early rejection could be implemented
      *       - not relevant for geometries with periodicity, though.
      */
     double Isobaric::_energyChange() {
-      double uold = _energy(spc->p);
+      predicted = predictable() && updatePowers();
+      double ufull=0;
+      if (predicted && validate)
+        ufull = _energy(spc->p);
+      double uold = predicted ? powerEnergy(1) + _external(spc->p) : _energy(spc->p);
       hamiltonian->setVolume( newV );
 
       // In spherical geometries, molecules may collide with
@@ -1008,6 +1500,18 @@ namespace Faunus {
         for (auto i : *g)
           if ( spc->geo->collision( spc->trial[i], Geometry::Geometrybase::BOUNDARY ) )
             return pc::infty;
+      if (predicted) {
+        double unew = _external(spc->trial);
+        if (unew<pc::infty)
+          unew += powerEnergy( std::cbrt(newV/oldV) );
+        cntpredict++;
+        if (validate && unew<pc::infty) {
+          double err = std::abs( (unew-uold) - (_energy(spc->trial)-ufull) );
+          maxerr = std::max(maxerr, err);
+          assert( err < 1e-6*(1+std::abs(unew-uold)) && "Predicted volume energy differs from full evaluation");
+        }
+        return unew-uold;
+      }
       double unew = _energy(spc->trial);
       return unew-uold;
     }
@@ -1018,65 +1522,117 @@ namespace Faunus {
 
     particle::Tid AtomTracker::randomAtomType() const {
       assert(!map.empty() && "No atom types have been added yet");
-      vector<particle::Tid> vid;
-      vid.reserve( map.size() );
-      for (auto &m : map) 
-        vid.push_back(m.first);
-      std::random_shuffle(vid.begin(), vid.end());
-      return vid.front();
+      auto it=map.begin();
+      std::advance(it, slp_global.rand() % map.size());
+      return it->first;
     }
 
     void AtomTracker::clear() {
       map.clear();
+      slots.clear();
     }
 
     AtomTracker::AtomTracker(Space &s) { spc=&s; }
 
-    AtomTracker::Tindex AtomTracker::data::random() {
-      std::random_shuffle( index.begin(), index.end() );
-      return index.back();
+    AtomTracker::Tindex AtomTracker::data::random() const {
+      assert(!index.empty());
+      return index[ slp_global.rand() % index.size() ];
     }
 
-    AtomTracker::data& AtomTracker::operator[](particle::Tid id) { return map[id]; }
+    const AtomTracker::data& AtomTracker::operator[](particle::Tid id) { return map[id]; }
+
+    void AtomTracker::track(Tindex i) {
+      data &d=map[ spc->p[i].id ];
+      slots[i] = {&d, (int)d.index.size()};
+      d.index.push_back(i);
+    }
+
+    /**
+     * The last entry in the species list is moved into the vacant position.
+     */
+    void AtomTracker::untrack(Tindex i) {
+      slot s=slots[i];
+      assert(s.d!=nullptr && "Particle is not tracked");
+      Tindex moved=s.d->index.back();
+      s.d->index[s.pos]=moved;
+      slots[moved].pos=s.pos;
+      s.d->index.pop_back();
+      slots[i] = {nullptr,-1};
+    }
+
+    void AtomTracker::shift(Tindex first) {
+      for (Tindex k=first; k<(Tindex)slots.size(); k++)
+        if (slots[k].d!=nullptr)
+          slots[k].d->index[ slots[k].pos ] = k;
+    }
+
+    /**
+     * @param i Index of particle in Space to track
+     */
+    void AtomTracker::add(Tindex i) {
+      assert(i>=0 && i<(int)spc->p.size());
+      if (slots.size()<spc->p.size())
+        slots.resize( spc->p.size(), {nullptr,-1} );
+      if (slots[i].d==nullptr)
+        track(i);
+    }
 
     /**
      * This will insert a particle into Space and at the same time make sure
-     * that all other particles are correctly tracked.
+     * that all other particles are correctly tracked. Only particles at or
+     * above `index` are touched.
      */
     bool AtomTracker::insert(const particle &a, Tindex index) {
-      assert( a.id == spc->p[ map[a.id].index.back() ].id && "Id mismatch");
+      slots.resize( spc->p.size(), {nullptr,-1} );
+      if (index<0 || index>(Tindex)slots.size())
+        index=slots.size();
       spc->insert(a, index); // insert into Space
-      for (auto &m : map)    // loop over all maps
-        for (auto &i : m.second.index) // and their particle index
-          if (i>=index) i++; // push forward particles beyond inserted particle
-      map[a.id].index.push_back(index); // finally, add particle to appripriate map
+      slots.insert(slots.begin()+index, {nullptr,-1});
+      shift(index+1);        // push forward particles beyond inserted particle
+      track(index);          // finally, add particle to appropriate list
       return true;
     }
 
     bool AtomTracker::erase(AtomTracker::Tindex index) {
-      spc->erase(index);
-      bool deleted=false;
-      for (auto &m : map) {
-        auto f=std::find(m.second.index.begin(), m.second.index.end(), index);
-        if (f!=m.second.index.end()) {
-          m.second.index.erase(f);
-          deleted=true;
-          break;
-        }
+      if (index<0 || index>=(Tindex)slots.size() || slots[index].d==nullptr) {
+        assert(!"Could not delete specified index");
+        return false;
       }
-      if (deleted)
-        for (auto &m : map)
-          for (auto &i : m.second.index)
-            if (i>index) i--;
+      untrack(index);
+      spc->erase(index);
+      slots.erase(slots.begin()+index);
+      shift(index);
+      return true;
+    }
 
+    /**
+     * @param index Particle to delete
+     * @param g Atomic group containing `index`
+     *
+     * The last particle in `g` is moved to `index` and the tail of the group is
+     * removed. Particle order within the group is thus not preserved.
+     */
+    bool AtomTracker::erase(AtomTracker::Tindex index, Group &g) {
+      if (index<0 || index>=(Tindex)slots.size() || slots[index].d==nullptr) {
+        assert(!"Could not delete specified index");
+        return false;
+      }
+      Tindex last=g.back();
+      untrack(index);
+      spc->eraseSwap(index, g);
+      if (last!=index) {
+        slots[index]=slots[last];
+        if (slots[index].d!=nullptr)
+          slots[index].d->index[ slots[index].pos ] = index;
+      }
+      slots.erase(slots.begin()+last);
+      shift(last);
 #ifndef NDEBUG
-      assert(deleted && "Could not delete specified index");
-      for (auto &m : map) {
-        for (auto &i : m.second.index)
+      for (auto &m : map)
+        for (auto i : m.second)
           assert( m.first == spc->p[i].id && "Particle id mismatch");
-      }
 #endif
-      return deleted;
+      return true;
     }
 
     GrandCanonicalSalt::GrandCanonicalSalt(InputMap &in, Energy::Hamiltonian &e, Space &s, Group &g, string pfx) :
@@ -1099,7 +1655,7 @@ namespace Faunus {
         if ( atom[id].activity>1e-10 && abs(atom[id].charge)>1e-10 ) {
           map[id].p=atom[id];
           map[id].chempot=log( atom[id].activity*pc::Nav*1e-27); // beta mu
-          tracker[id].index.push_back(i);
+          tracker.add(i);
         }
       }
       assert(!tracker.empty() && "No GC ions found!");
@@ -1108,13 +1664,14 @@ namespace Faunus {
     void GrandCanonicalSalt::randomIonPair(particle::Tid &id_cation, particle::Tid &id_anion) {
       do id_anion  = tracker.randomAtomType(); while ( map[id_anion].p.charge>=0);
       do id_cation = tracker.randomAtomType(); while ( map[id_cation].p.charge<=0  );
-      assert( !tracker[id_anion].index.empty() && "Ion list is empty");
-      assert( !tracker[id_cation].index.empty() && "Ion list is empty");
+      assert( !tracker[id_anion].empty() && "Ion list is empty");
+      assert( !tracker[id_cation].empty() && "Ion list is empty");
     }
 
     void GrandCanonicalSalt::_trialMove() {
       trial_insert.clear();
       trial_delete.clear();
+      changed.count=true;
       randomIonPair(ida, idb);
       assert(ida>0 && idb>0 &&
           "Ion pair id is zero (UNK). Is this really what you want?");
@@ -1156,9 +1713,9 @@ namespace Faunus {
         for (auto &t : trial_insert)     // count added ions
           if (t.id==map[ida].p.id) Na++; else Nb++;
         for (int n=0; n<Na; n++)
-          idfactor *= (tracker[ida].index.size()+1+n)/V;
+          idfactor *= (tracker[ida].size()+1+n)/V;
         for (int n=0; n<Nb; n++)
-          idfactor *= (tracker[idb].index.size()+1+n)/V;
+          idfactor *= (tracker[idb].size()+1+n)/V;
 
         unew = log(idfactor) - Na*map[ida].chempot - Nb*map[idb].chempot;
         du_rest=unew;
@@ -1176,9 +1733,9 @@ namespace Faunus {
           else if (spc->p[i].id==map[idb].p.id) Nb++;
         }
         for (int n=0; n<Na; n++)
-          idfactor *= (tracker[ida].index.size()-Na+1+n)/V;
+          idfactor *= (tracker[ida].size()-Na+1+n)/V;
         for (int n=0; n<Nb; n++)
-          idfactor *= (tracker[idb].index.size()-Nb+1+n)/V;
+          idfactor *= (tracker[idb].size()-Nb+1+n)/V;
 
         unew = -log(idfactor) + Na*map[ida].chempot + Nb*map[idb].chempot;
         du_rest=unew;
@@ -1203,18 +1760,18 @@ namespace Faunus {
       else if ( !trial_delete.empty() ) {
         std::sort(trial_delete.rbegin(), trial_delete.rend()); //reverse sort
         for (auto i : trial_delete)
-          tracker.erase(i);
+          tracker.erase(i, *saltPtr);
       }
       Urest.add(du_rest);
       double V = spc->geo->getVolume();
-      map[ida].rho += tracker[ida].index.size() / V;
-      map[idb].rho += tracker[idb].index.size() / V;
+      map[ida].rho += tracker[ida].size() / V;
+      map[idb].rho += tracker[idb].size() / V;
     }
 
     void GrandCanonicalSalt::_rejectMove() {
       double V = spc->geo->getVolume();
-      map[ida].rho += tracker[ida].index.size() / V;
-      map[idb].rho += tracker[idb].index.size() / V;
+      map[ida].rho += tracker[ida].size() / V;
+      map[idb].rho += tracker[idb].size() / V;
     }
 
     string GrandCanonicalSalt::_info() {
@@ -1314,8 +1871,11 @@ namespace Faunus {
 
         // update group trial mass-centers. Needed if energy calc. uses
         // cm_trial for cut-offs, for example
-        for (auto g : spc->groupList())
+        for (auto g : spc->groupList()) {
           g->cm_trial = Geometry::massCenter(*spc->geo, spc->trial, *g);
+          changed.groups.insert(g);
+        }
+        changed.volume=true;
 
         // debug assertions
         assert(pt.recvExtra[VOLUME]>1e-6 && "Invalid partner volume received.");
@@ -1403,5 +1963,174 @@ namespace Faunus {
 
 #endif
 
+    /**
+     * @param in InputMap
+     * @param mpi MPI controller. If `nullptr`, all replicas are in this process.
+     * @param pfx InputMap prefix
+     */
+#ifdef ENABLE_MPI
+    ReplicaExchange::ReplicaExchange(InputMap &in, Faunus::MPI::MPIController *mpi, string pfx) : mpiPtr(mpi) {
+#else
+    ReplicaExchange::ReplicaExchange(InputMap &in, string pfx) {
+#endif
+      int seed = in.get<int>(pfx+"_seed", 0, "Replica exchange random seed");
+      if (seed!=0)
+        rng.seed(seed);
+      usys = Energy::systemEnergy;
+      cnt=0;
+      first=0;
+      total=0;
+      inflight=false;
+    }
+
+    void ReplicaExchange::add(Space &spc, Energy::Energybase &pot) {
+      assert(total==0 && "Replicas must be added before first exchange");
+      replica r;
+      r.spc=&spc;
+      r.pot=&pot;
+      r.state=rep.size();
+      rep.push_back(r);
+    }
+
+    int ReplicaExchange::size() const { return rep.size(); }
+
+    int ReplicaExchange::state(int i) const { return rep.at(i).state; }
+
+    /**
+     * Find the global numbering of replicas and states. With MPI this
+     * requires a (single) blocking collective call.
+     */
+    void ReplicaExchange::setup() {
+      int nproc=1, rank=0;
+      counts.assign(1, 4*rep.size());
+#ifdef ENABLE_MPI
+      if (mpiPtr!=nullptr) {
+        nproc=mpiPtr->nproc();
+        rank=mpiPtr->rank();
+        int n=4*rep.size();
+        counts.resize(nproc);
+        MPI_Allgather(&n, 1, MPI_INT, &counts[0], 1, MPI_INT, mpiPtr->comm);
+      }
+#endif
+      displ.assign(nproc,0);
+      for (int i=1; i<nproc; i++)
+        displ[i]=displ[i-1]+counts[i-1];
+      total=(displ.back()+counts.back())/4;
+      first=displ[rank]/4;
+      stateOf.resize(total);
+      for (auto &r : rep) {
+        r.state+=first;
+        assert(setState && "ReplicaExchange::setState must be set");
+        setState(*r.pot, r.state);
+      }
+      sendBuf.resize(4*rep.size());
+      recvBuf.resize(4*total);
+    }
+
+    double ReplicaExchange::energy(replica &r, int k) {
+      if (k<0 || k>=total)
+        return 0;
+      if (k==r.state)
+        return usys(*r.spc, *r.pot, r.spc->p);
+      setState(*r.pot, k);
+      double u=usys(*r.spc, *r.pot, r.spc->p);
+      setState(*r.pot, r.state);
+      return u;
+    }
+
+    void ReplicaExchange::post() {
+      assert(!inflight && "Exchange already posted");
+      if (total==0)
+        setup();
+      for (size_t i=0; i<rep.size(); i++) {
+        auto &r=rep[i];
+        for (int d=-1; d<=1; d++)
+          r.u[d+1]=energy(r, r.state+d);
+        sendBuf[4*i]=r.state;
+        std::copy(r.u, r.u+3, &sendBuf[4*i+1]);
+      }
+#ifdef ENABLE_MPI
+      if (mpiPtr!=nullptr) {
+#if MPI_VERSION>=3
+        MPI_Iallgatherv(&sendBuf[0], sendBuf.size(), MPI_DOUBLE, &recvBuf[0],
+            &counts[0], &displ[0], MPI_DOUBLE, mpiPtr->comm, &req);
+#else
+        MPI_Allgatherv(&sendBuf[0], sendBuf.size(), MPI_DOUBLE, &recvBuf[0],
+            &counts[0], &displ[0], MPI_DOUBLE, mpiPtr->comm);
+#endif
+        inflight=true;
+        return;
+      }
+#endif
+      recvBuf=sendBuf;
+      inflight=true;
+    }
+
+    /**
+     * All processes hold identical energies and random number generators
+     * and therefore arrive at the same swaps without further communication.
+     */
+    void ReplicaExchange::complete() {
+      assert(inflight && "No exchange posted");
+#if defined(ENABLE_MPI) && MPI_VERSION>=3
+      if (mpiPtr!=nullptr)
+        MPI_Wait(&req, MPI_STATUS_IGNORE);
+#endif
+      inflight=false;
+      vector<int> replicaIn(total);                 // replica in each state
+      for (int g=0; g<total; g++)
+        replicaIn[ int(recvBuf[4*g]) ]=g;
+      for (int k=cnt%2; k+1<total; k+=2) {
+        int i=replicaIn[k], j=replicaIn[k+1];        // i in state k, j in state k+1
+        double *ui=&recvBuf[4*i+1], *uj=&recvBuf[4*j+1];
+        double du = (uj[0]+ui[2]) - (ui[1]+uj[1]);   // u_k(j)+u_k+1(i)-u_k(i)-u_k+1(j)
+        std::ostringstream o;
+        o << k << " <-> " << k+1;
+        if (rng() < std::exp(-du)) {
+          std::swap(replicaIn[k], replicaIn[k+1]);
+          accmap[ o.str() ] += 1;
+        } else
+          accmap[ o.str() ] += 0;
+      }
+      for (int k=0; k<total; k++)
+        stateOf[ replicaIn[k] ]=k;
+      for (size_t i=0; i<rep.size(); i++) {
+        auto &r=rep[i];
+        int k=stateOf[first+i];
+        if (k!=r.state) {
+          r.state=k;
+          setState(*r.pot, k);
+        }
+      }
+      cnt++;
+    }
+
+    void ReplicaExchange::exchange() {
+      post();
+      complete();
+    }
+
+    string ReplicaExchange::info() {
+      char w=30;
+      std::ostringstream o;
+      o << header("Replica Exchange")
+        << pad(SUB,w,"Local replicas") << rep.size() << endl
+        << pad(SUB,w,"Total replicas") << total << endl
+        << pad(SUB,w,"Number of exchanges") << cnt << endl
+        << indent(SUB) << "Local states:";
+      for (auto &r : rep)
+        o << " " << r.state;
+      o << endl;
+      if (cnt>0) {
+        o << indent(SUB) << "Acceptance:" << endl;
+        o.precision(3);
+        for (auto &m : accmap)
+          o << indent(SUBSUB) << std::left << setw(12)
+            << m.first << setw(8) << m.second.cnt << m.second.avg()*100 << percent << endl;
+      }
+      return o.str();
+    }
+
+
   }//namespace
 }//namespace
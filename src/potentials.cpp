@@ -389,6 +389,22 @@ namespace Faunus {
       return o.str();
     }
 
+    CoulombEwald::CoulombEwald(InputMap &in) : Coulomb(in) {
+      alpha=in.get<double>("ewald_alpha", 0.2, "Ewald damping parameter (1/AA)");
+      double Rc=in.get<double>("ewald_cutoff", 10., "Ewald real space cut-off (AA)");
+      Rc2=Rc*Rc;
+      name+=" Ewald real space";
+    }
+
+    string CoulombEwald::info(char w) {
+      using namespace textio;
+      std::ostringstream o;
+      o << Coulomb::info(w)
+        << pad(SUB,w,"Ewald alpha") << alpha << _angstrom+superminus+"1\n"
+        << pad(SUB,w,"Cut-off") << sqrt(Rc2) << _angstrom+"\n";
+      return o.str();
+    }
+
     ChargeNonpolar::ChargeNonpolar(InputMap &in) : Coulomb(in) {
       name="Charge-Nonpolar";
       c=bjerrumLength()/2*in.get<double>("excess_polarization", -1);
@@ -1,4 +1,8 @@
 #include <faunus/slump.h>
+#include <faunus/checkpoint.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace Faunus {
   RandomBase::~RandomBase() {}
@@ -12,6 +16,11 @@ namespace Faunus {
     return _randone() * max;
   }
 
+  /** @brief Default does not support checkpointing and writes nothing */
+  void RandomBase::save(std::ostream&) {}
+
+  bool RandomBase::load(std::istream&) { return false; }
+
   const double RandomRan2::EPS=3.0e-16;
 
   RandomRan2::RandomRan2() {
@@ -65,6 +74,138 @@ namespace Faunus {
     }
   }
 
+  void RandomRan2::save(std::ostream &o) {
+    Binary::write(o,idum);
+    Binary::write(o,idum2);
+    Binary::write(o,iy);
+    Binary::write(o,iv);
+  }
+
+  bool RandomRan2::load(std::istream &in) {
+    Binary::read(in,idum);
+    Binary::read(in,idum2);
+    Binary::read(in,iy);
+    Binary::read(in,iv);
+    return bool(in);
+  }
+
+  namespace {
+    inline uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    inline uint64_t splitmix64(uint64_t &x) {
+      uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+      return z ^ (z >> 31);
+    }
+  }
+
+  uint64_t RandomXoshiro::Engine::operator()() {
+    const uint64_t result = rotl(s[1] * 5, 7) * 9;
+    const uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return result;
+  }
+
+  void RandomXoshiro::Engine::jump() {
+    static const uint64_t JUMP[] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+      0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+    uint64_t t[4] = {0,0,0,0};
+    for (auto j : JUMP)
+      for (int b=0; b<64; b++) {
+        if (j & (uint64_t(1) << b))
+          for (int i=0; i<4; i++)
+            t[i] ^= s[i];
+        (*this)();
+      }
+    for (int i=0; i<4; i++)
+      s[i]=t[i];
+  }
+
+  RandomXoshiro::RandomXoshiro() {
+    name="xoshiro256** (per thread streams)";
+    seed(-13);
+  }
+
+  void RandomXoshiro::seed(int s) {
+    _seed=s;
+    int n=1;
+#ifdef _OPENMP
+    n=omp_get_max_threads();
+#endif
+    streams.resize(n);
+    uint64_t x=uint64_t(int64_t(s));
+    splitmix64(x);
+    for (auto &si : streams[0].s)
+      si=splitmix64(x);
+    for (int k=1; k<n; k++) {
+      streams[k]=streams[k-1];
+      streams[k].jump();
+    }
+    overflow=streams.back();
+    overflow.jump();
+  }
+
+  /**
+   * The returned engine is a copy and independent of the per-thread
+   * streams used by `operator()`. The state is generated by SplitMix64
+   * from the seed and `k` so that the cost is independent of `k`.
+   */
+  RandomXoshiro::Engine RandomXoshiro::stream(uint64_t k) const {
+    Engine e;
+    uint64_t x=uint64_t(int64_t(_seed)) ^ ((k+1) * 0xd1b54a32d192ed03ULL);
+    splitmix64(x);
+    for (auto &si : e.s)
+      si=splitmix64(x);
+    for (auto &pi : e.pad)
+      pi=0;
+    return e;
+  }
+
+  /**
+   * All per-thread streams are saved. If the number of threads differs
+   * upon loading, missing streams are obtained by jumping from the last one.
+   */
+  void RandomXoshiro::save(std::ostream &o) {
+    Binary::write(o,_seed);
+    Binary::write(o,streams);
+  }
+
+  bool RandomXoshiro::load(std::istream &in) {
+    size_t n=streams.size();
+    Binary::read(in,_seed);
+    Binary::read(in,streams);
+    if (!in || streams.empty())
+      return false;
+    for (size_t k=streams.size(); k<n; k++) {
+      streams.push_back( streams.back() );
+      streams.back().jump();
+    }
+    overflow=streams.back();
+    overflow.jump();
+    return true;
+  }
+
+  double RandomXoshiro::_randone() {
+#ifdef _OPENMP
+    int i=omp_get_thread_num();
+    if (i>=int(streams.size())) {
+      double x;
+#pragma omp critical (xoshiro_overflow)
+      x=overflow.uniform();
+      return x;
+    }
+    return streams[i].uniform();
+#else
+    return streams[0].uniform();
+#endif
+  }
+
   slump slp_global;
 }//namespace
 
@@ -5,6 +5,7 @@
 #include <faunus/group.h>
 #include <faunus/point.h>
 #include <faunus/space.h>
+#include <faunus/checkpoint.h>
 #include <faunus/textio.h>
 
 namespace Faunus {
@@ -12,6 +13,8 @@ namespace Faunus {
   Space::Space(Geometry::Geometrybase &geoPtr) {
     assert(&geoPtr!=nullptr && "Space must have a well-defined geometry!");
     geo=&geoPtr;
+    usearrays=false;
+    nload=0;
   }
 
   Space::~Space() {}
@@ -90,6 +93,8 @@ namespace Faunus {
         g.resize( g.size()+1 );
       }
       g.setMassCenter(*this);
+      if (usearrays)
+        syncArrays();
     }
     return g;
   }
@@ -115,6 +120,8 @@ namespace Faunus {
       if ( gj->front() > i ) gj->setfront( gj->front()+1  ); // gj->beg++;
       if ( gj->back() >= i ) gj->setback( gj->back()+1 );    //gj->last++; // +1 is a special case for adding to the end of p-vector
     }
+    if (usearrays)
+      syncArrays();
     return true;
   }
 
@@ -147,9 +154,31 @@ namespace Faunus {
       if ( i<=gj->back() ) gj->setback( gj->back()-1);     //gj->last--;
       assert( gj->back()>=0 && "Particle removal resulted in empty Group");
     }
+    if (usearrays)
+      syncArrays();
     return true;
   }
 
+  /**
+   * @param i Particle to remove
+   * @param g Atomic group that contains `i`
+   *
+   * The last particle of `g` is copied to position `i` whereafter the
+   * last position of the group is erased. Only particles beyond the group
+   * are shifted and removal is thus a constant time operation if `g` is
+   * placed at the end of the particle vector. The order of particles within
+   * `g` is not preserved so this should be used for atomic groups only.
+   */
+  bool Space::eraseSwap(int i, Group &g) {
+    assert( g.find(i) && "Particle not in group" );
+    int last=g.back();
+    if (i!=last) {
+      p[i]=p[last];
+      trial[i]=trial[last];
+    }
+    return erase(last);
+  }
+
   bool Space::overlap_container() const {
     for (auto &i : p)
       if (geo->collision(i))
@@ -228,7 +257,10 @@ namespace Faunus {
           for (int i=0; i<n; i++)
             p[i] << fin;
           trial=p;
+          if (usearrays)
+            syncArrays();
           cout << indent(SUB) << "Read " << n << " particle(s)." << endl;
+          nload++;
           fin >> n;
           if (n==(int)g.size()) {
             for (auto g_i : g) {
@@ -249,6 +281,57 @@ namespace Faunus {
     return false;
   }
 
+  /**
+   * The volume, particles and group ranges are written as raw binary data
+   * for use with `Checkpoint`.
+   */
+  void Space::save(std::ostream &o) {
+    Binary::write(o, geo->getVolume());
+    Binary::write(o, p);
+    Binary::write(o, uint64_t(g.size()));
+    for (auto g_i : g) {
+      Binary::write(o, g_i->front());
+      Binary::write(o, g_i->back());
+    }
+  }
+
+  /**
+   * The particle vectors are resized to match the stream while the number
+   * of groups must match those already enrolled. The whole section is read
+   * and validated before anything is changed so that `Space` is untouched
+   * if `false` is returned.
+   */
+  bool Space::load(std::istream &in) {
+    double vol;
+    p_vec pnew;
+    uint64_t n=0;
+    Binary::read(in, vol);
+    Binary::read(in, pnew);
+    Binary::read(in, n);
+    if (!in || n!=g.size())
+      return false;
+    std::vector<std::pair<int,int> > range(n);
+    for (auto &r : range) {
+      Binary::read(in, r.first);
+      Binary::read(in, r.second);
+      if ( r.second>=int(pnew.size()) || (r.first>=0 && r.second<r.first-1) )
+        return false;
+    }
+    if (!in)
+      return false;
+    geo->setVolume(vol);
+    p.swap(pnew);
+    trial=p;
+    if (usearrays)
+      syncArrays();
+    for (size_t i=0; i<n; i++) {
+      g[i]->setrange(range[i].first, range[i].second);
+      g[i]->setMassCenter(*this);
+    }
+    nload++;
+    return true;
+  }
+
   /**
    * Call to this function is *optional* and may provide better
    * handling of memory in cases where the maximum number of
@@ -328,4 +411,120 @@ namespace Faunus {
     }
   }
 
+  void ParticleArrays::update(const p_vec &p) {
+    int n=p.size();
+    x.resize(n);
+    y.resize(n);
+    z.resize(n);
+    charge.resize(n);
+    radius.resize(n);
+    id.resize(n);
+    for (int i=0; i<n; i++)
+      set(i, p[i]);
+  }
+
+  /**
+   * When enabled, the structure-of-arrays mirrors `p_arr` and `trial_arr`
+   * are updated by `Group::accept()`, `Group::undo()`, particle insertion
+   * and deletion, and by `Move::Movebase` for all particles touched by
+   * a move. If particles are modified elsewhere, call `syncArrays()`.
+   */
+  void Space::enableArrays(bool b) {
+    usearrays=b;
+    if (usearrays)
+      syncArrays();
+  }
+
+  /**
+   * @return Pointer to `p_arr` or `trial_arr` if `v` is `p` or `trial`, respectively.
+   *         If mirrors are disabled or out of sync, `nullptr` is returned.
+   */
+  const ParticleArrays* Space::arrays(const p_vec &v) const {
+    if (usearrays) {
+      if (&v==&p && p_arr.size()==(int)p.size())
+        return &p_arr;
+      if (&v==&trial && trial_arr.size()==(int)trial.size())
+        return &trial_arr;
+    }
+    return nullptr;
+  }
+
+  void Space::syncArrays() {
+    p_arr.update(p);
+    trial_arr.update(trial);
+  }
+
+  void Space::syncArrays(int i) {
+    assert(i>=0 && i<p_arr.size() && i<trial_arr.size() && "Particle arrays out of sync");
+    p_arr.set(i, p[i]);
+    trial_arr.set(i, trial[i]);
+  }
+
+  void Space::syncArrays(const std::set<int> &index) {
+    if (index.empty())
+      syncArrays();
+    else
+      for (auto i : index)
+        syncArrays(i);
+  }
+
+  void Space::syncArrays(const Change &c) {
+    if (c.all())
+      syncArrays();
+    else
+      syncArrays(c.index);
+  }
+
+  /**
+   * Only the particles in `Change::index` are copied from `trial` to `p`,
+   * and the mass centers of `Change::groups`. If `Change::all()` is true,
+   * the full particle vector is copied.
+   */
+  void Space::accept(const Change &c) {
+    if (c.all())
+      p=trial;
+    else
+      for (auto i : c.index)
+        p[i]=trial[i];
+    for (auto g : c.groups)
+      g->cm=g->cm_trial;
+    if (usearrays)
+      syncArrays(c);
+  }
+
+  /** @brief Reverse of `accept()` */
+  void Space::undo(const Change &c) {
+    if (c.all())
+      trial=p;
+    else
+      for (auto i : c.index)
+        trial[i]=p[i];
+    for (auto g : c.groups)
+      g->cm_trial=g->cm;
+    if (usearrays)
+      syncArrays(c);
+  }
+
+  Change::Change() : volume(false), count(false) {}
+
+  void Change::clear() {
+    index.clear();
+    groups.clear();
+    volume=count=false;
+  }
+
+  bool Change::all() const {
+    return index.empty() || volume || count;
+  }
+
+  void Change::insert(int i) {
+    index.insert(i);
+  }
+
+  void Change::insert(Group &g) {
+    groups.insert(&g);
+    for (auto i : g)
+      index.insert(index.end(), i);
+  }
+
 }//namespace
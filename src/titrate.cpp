@@ -326,6 +326,7 @@ namespace Faunus {
         k=slp_global.rand() % eqpot.eq.process.size(); // pick random process..
       } while (!eqpot.eq.process[k].one_of_us( spc->p[ipart].id )); //that match particle j
       eqpot.eq.process[k].swap( spc->trial[ipart] ); // change state and get intrinsic energy change
+      changed.insert(ipart);
     }
 
     double SwapMove::_energyChange() {
@@ -333,7 +334,7 @@ namespace Faunus {
           && "Accepted particle collides with container");
       if (spc->geo->collision(spc->trial[ipart]))  // trial<->container collision?
         return pc::infty;
-      return pot->i_total(spc->trial,ipart) - pot->i_total(spc->p,ipart);
+      return pot->i_total_change(spc->trial,spc->p,ipart);
     }
 
     void SwapMove::_acceptMove() {
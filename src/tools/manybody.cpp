@@ -57,6 +57,9 @@ int main(int argc, char** argv) {
 
   spc.load(state);
 
+  if ( mcp.get<bool>("groupcache", false) )
+    pot.enableGroupCache(spc);             // cache protein-protein energies
+
   double utot=pot.all2all(spc.p) + pot.external();
   for (auto g : spc.groupList())
     utot+=pot.g_external(spc.p, *g);